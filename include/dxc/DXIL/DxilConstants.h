@@ -422,6 +422,8 @@ enum class PackingStrategy : unsigned {
   Optimized, // Optimize packing of all elements together (all elements must be
              // present, in the same order, for identical placement of any
              // individual element)
+  Minimal,   // Search for the packing using the fewest rows, starting from
+             // Optimized (same requirements as Optimized)
   Invalid,
 };
 
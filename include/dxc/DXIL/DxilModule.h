@@ -187,7 +187,10 @@ public:
   /// Note: this method not update Metadata for ViewIdState.
   void ReEmitDxilResources();
   /// Deserialize DXIL metadata form into in-memory form.
-  void LoadDxilMetadata();
+  /// With bLazyTypeSystem, type and payload annotations are decoded on the
+  /// first GetTypeSystem() call instead. Only use it when the DXIL metadata
+  /// is not modified outside of DxilModule before that point.
+  void LoadDxilMetadata(bool bLazyTypeSystem = false);
   /// Return true if non-fatal metadata error was detected.
   bool HasMetadataErrors();
 
@@ -397,9 +400,15 @@ private:
   // Validator will fail in this case, but should not block module load.
   bool m_bMetadataErrors = false;
 
+  // True while type annotations are still only in metadata form because
+  // LoadDxilMetadata was asked to defer them.
+  bool m_bTypeSystemLoadPending = false;
+
   // DXIL metadata serialization/deserialization.
   llvm::MDTuple *EmitDxilResources();
   void LoadDxilResources(const llvm::MDOperand &MDO);
+  void LoadDxilTypeSystem();
+  void LoadPendingTypeSystem() const;
 
   // Helpers.
   template <typename T>
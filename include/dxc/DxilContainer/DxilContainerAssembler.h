@@ -91,6 +91,10 @@ void SerializeDxilContainerForModule(
     AbstractMemoryStream *pReflectionStreamOut = nullptr,
     AbstractMemoryStream *pRootSigStreamOut = nullptr,
     void *pPrivateData = nullptr, size_t PrivateDataSize = 0);
+// Write only the reflection output of SerializeDxilContainerForModule, without
+// assembling the container. Strips the module the same way.
+void SerializeDxilReflectionForModule(
+    hlsl::DxilModule *pModule, AbstractMemoryStream *pReflectionStreamOut);
 void SerializeDxilContainerForRootSignature(
     hlsl::RootSignatureHandle *pRootSigHandle, AbstractMemoryStream *pStream);
 
@@ -379,6 +379,17 @@ bool VerifyRootSignatureWithShaderPSV(
     const DxilVersionedRootSignatureDesc *pDesc, DXIL::ShaderKind ShaderKind,
     const void *pPSVData, uint32_t PSVSize, llvm::raw_ostream &DiagStream);
 
+// Batch form of VerifyRootSignatureWithShaderPSV: the root signature is
+// verified and its register ranges indexed once, then each of the NumShaders
+// PSVs is checked against it. pResults[i] receives whether shader i is
+// compatible, and its diagnostics are prefixed with "shader <i>: ". Returns
+// false if the root signature itself is invalid (all results are then false)
+// or if any shader is incompatible.
+bool VerifyRootSignatureWithShaderPSVs(
+    const DxilVersionedRootSignatureDesc *pDesc, uint32_t NumShaders,
+    const DXIL::ShaderKind *pShaderKinds, const void *const *ppPSVData,
+    const uint32_t *pPSVSizes, bool *pResults, llvm::raw_ostream &DiagStream);
+
 // standalone verification
 bool VerifyRootSignature(const DxilVersionedRootSignatureDesc *pDesc,
                          llvm::raw_ostream &DiagStream,
@@ -172,12 +172,25 @@ public:
   unsigned PackPrefixStable(std::vector<PackElement *> elements,
                             unsigned startRow, unsigned numRows);
 
+  // Search for the packing using the fewest rows, starting from the
+  // PackOptimized result.  Placements are tried depth-first and branches that
+  // cannot beat the best packing so far are pruned.  At most maxSteps
+  // placements are tried, so the result is bounded and deterministic.
+  static const unsigned kDefaultMaxMinimalPackSteps = 1 << 16;
+  unsigned PackMinimal(std::vector<PackElement *> elements, unsigned startRow,
+                       unsigned numRows,
+                       unsigned maxSteps = kDefaultMaxMinimalPackSteps);
+
   bool UseMinPrecision() const { return m_bUseMinPrecision; }
 
 protected:
   std::vector<PackedRegister> m_Registers;
   bool m_bIgnoreIndexing;
   bool m_bUseMinPrecision;
+
+  struct MinimalPackState;
+  void SearchMinimal(MinimalPackState &state, unsigned index,
+                     unsigned rowsUsed);
 };
 
 } // namespace hlsl
@@ -252,6 +252,43 @@ struct {
   }
 } CmpElementsLess;
 
+// Compare only the properties that affect where an element may be placed.
+int CmpPackProperties(const DxilSignatureAllocator::PackElement *left,
+                      const DxilSignatureAllocator::PackElement *right) {
+  int result;
+  result = cmp((unsigned)left->GetInterpretation(),
+               (unsigned)right->GetInterpretation());
+  if (result)
+    return result;
+  result = cmp((unsigned)left->GetInterpolationMode(),
+               (unsigned)right->GetInterpolationMode());
+  if (result)
+    return result;
+  result = cmp((unsigned)left->GetDataBitWidth(),
+               (unsigned)right->GetDataBitWidth());
+  if (result)
+    return result;
+  result = cmp(left->GetRows(), right->GetRows());
+  if (result)
+    return result;
+  return cmp(left->GetCols(), right->GetCols());
+}
+
+// Search order for PackMinimal: largest elements first, since they have the
+// fewest places to go, with interchangeable elements kept adjacent.
+struct {
+  bool operator()(const DxilSignatureAllocator::PackElement *left,
+                  const DxilSignatureAllocator::PackElement *right) {
+    int result = -cmp(left->GetRows() * left->GetCols(),
+                      right->GetRows() * right->GetCols());
+    if (!result)
+      result = CmpPackProperties(left, right);
+    if (!result)
+      result = cmp(left->GetID(), right->GetID());
+    return result < 0;
+  }
+} CmpElementsBySizeLess;
+
 } // anonymous namespace
 
 unsigned DxilSignatureAllocator::FindNext(unsigned &foundRow,
@@ -649,4 +686,116 @@ DxilSignatureAllocator::PackPrefixStable(std::vector<PackElement *> elements,
   return rowsUsed;
 }
 
+struct DxilSignatureAllocator::MinimalPackState {
+  std::vector<PackElement *> elements; // in search order
+  std::vector<bool> sameAsPrev; // interchangeable with the previous element
+  std::vector<std::pair<unsigned, unsigned>> locations;
+  std::vector<std::pair<unsigned, unsigned>> bestLocations;
+  unsigned startRow;
+  unsigned lowerBound; // no packing can use fewer rows than this
+  unsigned bestRowsUsed;
+  unsigned stepsLeft;
+};
+
+void DxilSignatureAllocator::SearchMinimal(MinimalPackState &S, unsigned index,
+                                           unsigned rowsUsed) {
+  if (rowsUsed >= S.bestRowsUsed)
+    return;
+  if (index == S.elements.size()) {
+    S.bestRowsUsed = rowsUsed;
+    S.bestLocations = S.locations;
+    return;
+  }
+
+  PackElement *SE = S.elements[index];
+  unsigned rows = SE->GetRows();
+  unsigned cols = SE->GetCols();
+  // PlaceElement only touches these rows, so save and restore just those.
+  // PackMinimal only searches elements that fit in this buffer.
+  PackedRegister saved[DXIL::kMaxSignatureTotalVectors];
+  unsigned row = S.startRow;
+  unsigned startCol = 0;
+  if (S.sameAsPrev[index]) {
+    // Only try locations after the previous, interchangeable element, so the
+    // same packing is not searched once per ordering of these elements.
+    row = S.locations[index - 1].first;
+    startCol = S.locations[index - 1].second + 1;
+  }
+  for (; row + rows < S.bestRowsUsed; ++row, startCol = 0) {
+    if (DetectRowConflict(SE, row))
+      continue;
+    for (unsigned col = startCol; col + cols <= 4; ++col) {
+      if (DetectColConflict(SE, row, col))
+        continue;
+      if (S.stepsLeft == 0)
+        return;
+      --S.stepsLeft;
+      std::copy(m_Registers.begin() + row, m_Registers.begin() + row + rows,
+                saved);
+      PlaceElement(SE, row, col);
+      S.locations[index] = std::make_pair(row, col);
+      SearchMinimal(S, index + 1, std::max(rowsUsed, row + rows));
+      std::copy(saved, saved + rows, m_Registers.begin() + row);
+      if (S.bestRowsUsed <= S.lowerBound)
+        return;
+    }
+  }
+}
+
+unsigned
+DxilSignatureAllocator::PackMinimal(std::vector<PackElement *> elements,
+                                    unsigned startRow, unsigned numRows,
+                                    unsigned maxSteps) {
+  std::vector<PackedRegister> initialRegisters = m_Registers;
+  unsigned rowsUsed = PackOptimized(elements, startRow, numRows);
+
+  // The PackOptimized result is the one to beat.  Keep it as is when an
+  // element failed to allocate, or for clip/cull, whose two register limit is
+  // not enforced by the row and column conflict checks used by the search,
+  // or when an element is too tall for the SearchMinimal restore buffer.
+  MinimalPackState S;
+  S.startRow = startRow;
+  S.lowerBound = startRow;
+  S.bestRowsUsed = rowsUsed;
+  S.stepsLeft = maxSteps;
+  unsigned numComponents = 0;
+  for (auto &SE : elements) {
+    if (!SE->IsAllocated() ||
+        SE->GetInterpretation() == DXIL::SemanticInterpretationKind::ClipCull ||
+        SE->GetRows() > DXIL::kMaxSignatureTotalVectors)
+      return rowsUsed;
+    numComponents += SE->GetRows() * SE->GetCols();
+    S.lowerBound = std::max(S.lowerBound, startRow + SE->GetRows());
+  }
+  S.lowerBound = std::max(S.lowerBound, startRow + (numComponents + 3) / 4);
+  if (rowsUsed <= S.lowerBound)
+    return rowsUsed;
+
+  S.elements = elements;
+  std::sort(S.elements.begin(), S.elements.end(), CmpElementsBySizeLess);
+  S.sameAsPrev.resize(S.elements.size(), false);
+  for (unsigned i = 1; i < S.elements.size(); ++i)
+    S.sameAsPrev[i] = CmpPackProperties(S.elements[i - 1], S.elements[i]) == 0;
+  S.locations.resize(S.elements.size());
+
+  std::vector<PackedRegister> optimizedRegisters;
+  optimizedRegisters.swap(m_Registers);
+  m_Registers = initialRegisters;
+  SearchMinimal(S, 0, 0);
+
+  if (S.bestLocations.empty()) {
+    // Nothing better found, keep the PackOptimized placement.
+    m_Registers.swap(optimizedRegisters);
+    return rowsUsed;
+  }
+
+  for (unsigned i = 0; i < S.elements.size(); ++i) {
+    unsigned row = S.bestLocations[i].first;
+    unsigned col = S.bestLocations[i].second;
+    PlaceElement(S.elements[i], row, col);
+    S.elements[i]->SetLocation(row, col);
+  }
+  return S.bestRowsUsed;
+}
+
 } // namespace hlsl
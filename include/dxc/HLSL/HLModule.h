@@ -62,7 +62,7 @@ struct HLOptions {
   unsigned bAllResourcesBound : 1;
   unsigned bDisableOptimizations : 1;
   unsigned PackingStrategy : 2;
-  static_assert((unsigned)DXIL::PackingStrategy::Invalid < 4,
+  static_assert((unsigned)DXIL::PackingStrategy::Invalid <= 4,
                 "otherwise 2 bits is not enough to store PackingStrategy");
   unsigned bUseMinPrecision : 1;
   unsigned bDX9CompatMode : 1;
@@ -163,6 +163,7 @@ public:
   bool DebugNameForBinary = false;        // OPT_Zsb
   bool DebugNameForSource = false;        // OPT_Zss
   bool DumpBin = false;                   // OPT_dumpbin
+  bool Batch = false;                     // OPT_batch
   bool DumpDependencies = false;          // OPT_dump_dependencies
   bool WriteDependencies = false;         // OPT_write_dependencies
   bool Link = false;                      // OPT_link
@@ -174,6 +175,7 @@ public:
   bool DisableValidation = false;         // OPT_VD
   unsigned OptLevel = 0;                  // OPT_O0/O1/O2/O3
   bool DisableOptimizations = false;      // OPT_Od
+  bool ReflectOnly = false;               // OPT_reflect_only
   bool AvoidFlowControl = false;          // OPT_Gfa
   bool PreferFlowControl = false;         // OPT_Gfp
   bool EnableStrictMode = false;          // OPT_Ges
@@ -193,6 +195,7 @@ public:
   bool UseInstructionNumbers = false;     // OPT_Ni
   bool PackPrefixStable = false;          // OPT_pack_prefix_stable
   bool PackOptimized = false;             // OPT_pack_optimized
+  bool PackMinimal = false;               // OPT_pack_minimal
   bool DisplayIncludeProcess = false;     // OPT__vi
   bool RecompileFromBinary =
       false; // OPT _Recompile (Recompiling the DXBC binary file not .hlsl file)
@@ -216,6 +219,8 @@ public:
   unsigned long AutoBindingSpace = UINT_MAX; // OPT_auto_binding_space
   bool ExportShadersOnly = false;            // OPT_export_shaders_only
   bool ResMayAlias = false;                  // OPT_res_may_alias
+  bool FreeFrontendEarly = false;            // OPT_free_frontend_early
+  unsigned MemoryBudgetKB = 0;               // OPT_memory_budget
   unsigned long ValVerMajor = UINT_MAX,
                 ValVerMinor = UINT_MAX; // OPT_validator_version
   unsigned ScanLimit = 0;               // OPT_memdep_block_scan_limit
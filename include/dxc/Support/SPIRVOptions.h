@@ -116,6 +116,9 @@ struct SpirvCodeGenOptions {
   bool printAll =
       false; // Dump SPIR-V module before each pass and after the last one.
 
+  bool fuseOptimizerPasses =
+      false; // Run all SPIRV-Tools stages with a single optimizer instance.
+
   // String representation of all command line options and input file.
   std::string clOptions;
   std::string inputFile;
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// dxcmem.h                                                                  //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Provides allocators layered over the thread-local allocator.              //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "dxc/Support/Global.h"
+#include "dxc/Support/WinIncludes.h"
+#include "dxc/Support/microcom.h"
+#include <atomic>
+#include <cstdint>
+
+namespace llvm {
+class raw_ostream;
+}
+
+// IMalloc that holds a single compile to a memory budget. Calls are forwarded
+// to the compiler's allocator; block sizes come from its GetSize, so no header
+// is added and blocks may be freed through either allocator. Once an
+// allocation would go over budget it fails, and the phase it happened in is
+// kept for the error message. Peak live bytes are tracked per phase.
+class DxcBudgetMalloc : public IMalloc {
+public:
+  enum Phase : unsigned {
+    PhaseSetup,
+    PhaseFrontend,
+    PhaseContainer,
+    PhaseDebugInfo,
+    PhaseCount
+  };
+
+private:
+  DXC_MICROCOM_TM_REF_FIELDS()
+  uint64_t m_Budget;
+  std::atomic<int64_t> m_Live;
+  std::atomic<int64_t> m_Peak[PhaseCount];
+  std::atomic<unsigned> m_Phase;
+  std::atomic<int> m_ExceededPhase;
+
+  int64_t SizeOf(void *pv);
+  bool WouldExceed(uint64_t size);
+  void UpdatePeak(int64_t live);
+  void Track(int64_t delta);
+
+public:
+  DxcBudgetMalloc(IMalloc *pMalloc, uint64_t budget);
+  DXC_MICROCOM_TM_ALLOC(DxcBudgetMalloc)
+  DXC_MICROCOM_TM_ADDREF_RELEASE_IMPL()
+
+  // Returns false if pMalloc cannot report block sizes, in which case the
+  // budget cannot be enforced.
+  static bool CanTrack(IMalloc *pMalloc);
+  static const char *GetPhaseName(unsigned phase);
+
+  void SetPhase(Phase phase);
+  bool IsExceeded() const { return m_ExceededPhase.load() >= 0; }
+  const char *GetExceededPhaseName() const {
+    return GetPhaseName((unsigned)m_ExceededPhase.load());
+  }
+  uint64_t GetBudget() const { return m_Budget; }
+  // Writes the budget as "N MB", or "N KB" if it is not whole megabytes.
+  void WriteBudget(llvm::raw_ostream &OS) const;
+  void WritePeaks(llvm::raw_ostream &OS) const;
+
+  STDMETHODIMP QueryInterface(REFIID iid, void **ppvObject) override {
+    return DoBasicQueryInterface<IMalloc>(this, iid, ppvObject);
+  }
+
+  void *STDMETHODCALLTYPE Alloc(SIZE_T cb) override;
+  void *STDMETHODCALLTYPE Realloc(void *pv, SIZE_T cb) override;
+  void STDMETHODCALLTYPE Free(void *pv) override;
+
+  SIZE_T STDMETHODCALLTYPE GetSize(void *pv) override {
+    return m_pMalloc->GetSize(pv);
+  }
+  int STDMETHODCALLTYPE DidAlloc(void *pv) override {
+    return m_pMalloc->DidAlloc(pv);
+  }
+  void STDMETHODCALLTYPE HeapMinimize(void) override {
+    m_pMalloc->HeapMinimize();
+  }
+};
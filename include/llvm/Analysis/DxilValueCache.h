@@ -10,12 +10,16 @@
 #ifndef LLVM_ANALYSIS_DXILVALUECACHE_H
 #define LLVM_ANALYSIS_DXILVALUECACHE_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/ValueMap.h"
 #include "llvm/Pass.h"
 
+#include <memory>
+
 namespace llvm {
 
 class Module;
+class Function;
 class DominatorTree;
 class Constant;
 class ConstantInt;
@@ -40,16 +44,24 @@ struct DxilValueCache : public ImmutablePass {
       }
       inline bool IsStale() const { return Self == nullptr; }
     };
-    ValueMap<const Value *, ValueEntry> Map;
+    typedef ValueMap<const Value *, ValueEntry> EntryMap;
+    // Entries grouped by the function that owns the key (null for keys
+    // outside any function), so resetting one function only touches its own
+    // entries.
+    DenseMap<const Function *, std::unique_ptr<EntryMap>> FunctionMaps;
     Value *Get(Value *V);
     void Set(Value *Key, Value *V);
     bool Seen(Value *v);
     void SetSentinel(Value *V);
     void ResetUnknowns();
     void ResetAll();
+    void ResetFunction(const Function *F);
     void dump() const;
 
   private:
+    static const Function *GetOwner(const Value *V);
+    ValueEntry *Find(const Value *V);
+    ValueEntry &GetOrCreate(const Value *V);
     Value *GetSentinel(LLVMContext &Ctx);
     std::unique_ptr<PHINode> Sentinel;
   };
@@ -81,6 +93,9 @@ public:
   ConstantInt *GetConstInt(Value *V, DominatorTree *DT = nullptr);
   void ResetUnknowns() { Map.ResetUnknowns(); }
   void ResetAll() { Map.ResetAll(); }
+  // Drop only the facts about values and blocks of F; cached results for the
+  // rest of the module stay valid.
+  void ResetFunction(const Function *F) { Map.ResetFunction(F); }
   bool IsUnreachable(BasicBlock *BB, DominatorTree *DT = nullptr);
   void SetShouldSkipCallback(bool (*Callback)(Value *V)) {
     ShouldSkipCallback = Callback;
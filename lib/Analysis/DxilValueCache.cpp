@@ -349,27 +349,48 @@ Value *DxilValueCache::SimplifyAndCacheResult(Instruction *I,
   return Simplified;
 }
 
-bool DxilValueCache::WeakValueMap::Seen(Value *V) {
-  auto FindIt = Map.find(V);
-  if (FindIt == Map.end())
-    return false;
+const Function *DxilValueCache::WeakValueMap::GetOwner(const Value *V) {
+  if (const Instruction *I = dyn_cast<Instruction>(V))
+    V = I->getParent();
+  if (const BasicBlock *BB = dyn_cast_or_null<BasicBlock>(V))
+    return BB->getParent();
+  if (const Argument *Arg = dyn_cast_or_null<Argument>(V))
+    return Arg->getParent();
+  return nullptr;
+}
+
+DxilValueCache::WeakValueMap::ValueEntry *
+DxilValueCache::WeakValueMap::Find(const Value *V) {
+  auto MapIt = FunctionMaps.find(GetOwner(V));
+  if (MapIt == FunctionMaps.end())
+    return nullptr;
+  auto FindIt = MapIt->second->find(V);
+  if (FindIt == MapIt->second->end())
+    return nullptr;
+  return &FindIt->second;
+}
+
+DxilValueCache::WeakValueMap::ValueEntry &
+DxilValueCache::WeakValueMap::GetOrCreate(const Value *V) {
+  std::unique_ptr<EntryMap> &Entries = FunctionMaps[GetOwner(V)];
+  if (!Entries)
+    Entries = llvm::make_unique<EntryMap>();
+  return (*Entries)[V];
+}
 
-  auto &Entry = FindIt->second;
-  if (Entry.IsStale())
+bool DxilValueCache::WeakValueMap::Seen(Value *V) {
+  ValueEntry *Entry = Find(V);
+  if (!Entry || Entry->IsStale())
     return false;
-  return Entry.Value;
+  return Entry->Value;
 }
 
 Value *DxilValueCache::WeakValueMap::Get(Value *V) {
-  auto FindIt = Map.find(V);
-  if (FindIt == Map.end())
+  ValueEntry *Entry = Find(V);
+  if (!Entry || Entry->IsStale())
     return nullptr;
 
-  auto &Entry = FindIt->second;
-  if (Entry.IsStale())
-    return nullptr;
-
-  Value *Result = Entry.Value;
+  Value *Result = Entry->Value;
   if (Result == GetSentinel(V->getContext()))
     return nullptr;
 
@@ -377,7 +398,7 @@ Value *DxilValueCache::WeakValueMap::Get(Value *V) {
 }
 
 void DxilValueCache::WeakValueMap::SetSentinel(Value *Key) {
-  Map[Key].Set(Key, GetSentinel(Key->getContext()));
+  GetOrCreate(Key).Set(Key, GetSentinel(Key->getContext()));
 }
 
 Value *DxilValueCache::WeakValueMap::GetSentinel(LLVMContext &Ctx) {
@@ -387,78 +408,91 @@ Value *DxilValueCache::WeakValueMap::GetSentinel(LLVMContext &Ctx) {
   return Sentinel.get();
 }
 
-void DxilValueCache::WeakValueMap::ResetAll() { Map.clear(); }
+void DxilValueCache::WeakValueMap::ResetAll() { FunctionMaps.clear(); }
+
+void DxilValueCache::WeakValueMap::ResetFunction(const Function *F) {
+  FunctionMaps.erase(F);
+  // Keys that belong to no function are cheap to recompute; drop them too so
+  // nothing derived from F's old state survives.
+  FunctionMaps.erase(nullptr);
+}
 
 void DxilValueCache::WeakValueMap::ResetUnknowns() {
   if (!Sentinel)
     return;
 
-  for (auto it = Map.begin(); it != Map.end();) {
-    auto nextIt = std::next(it);
-    if (it->second.Value == Sentinel.get())
-      Map.erase(it);
-    it = nextIt;
+  for (auto &FunctionMap : FunctionMaps) {
+    EntryMap &Entries = *FunctionMap.second;
+    for (auto it = Entries.begin(); it != Entries.end();) {
+      auto nextIt = std::next(it);
+      if (it->second.Value == Sentinel.get())
+        Entries.erase(it);
+      it = nextIt;
+    }
   }
 }
 
 LLVM_DUMP_METHOD
 void DxilValueCache::WeakValueMap::dump() const {
   std::unordered_map<const Module *, std::unique_ptr<ModuleSlotTracker>> MSTs;
-  for (auto It = Map.begin(), E = Map.end(); It != E; It++) {
-    const Value *Key = It->first;
-
-    if (It->second.IsStale())
-      continue;
-
-    if (!Key)
-      continue;
-
-    ModuleSlotTracker *MST = nullptr;
-    {
-      const Module *M = nullptr;
-      if (auto I = dyn_cast<Instruction>(Key))
-        M = I->getModule();
-      else if (auto BB = dyn_cast<BasicBlock>(Key))
-        M = BB->getModule();
-      else {
-        errs() << *Key;
-        llvm_unreachable("How can a key be neither an instruction or BB?");
-      }
-      std::unique_ptr<ModuleSlotTracker> &optMst = MSTs[M];
-      if (!optMst) {
-        optMst = llvm::make_unique<ModuleSlotTracker>(M);
+  for (const auto &FunctionMap : FunctionMaps) {
+    const EntryMap &Entries = *FunctionMap.second;
+    for (auto It = Entries.begin(), E = Entries.end(); It != E; It++) {
+      const Value *Key = It->first;
+
+      if (It->second.IsStale())
+        continue;
+
+      if (!Key)
+        continue;
+
+      ModuleSlotTracker *MST = nullptr;
+      {
+        const Module *M = nullptr;
+        if (auto I = dyn_cast<Instruction>(Key))
+          M = I->getModule();
+        else if (auto BB = dyn_cast<BasicBlock>(Key))
+          M = BB->getModule();
+        else {
+          errs() << *Key;
+          llvm_unreachable("How can a key be neither an instruction or BB?");
+        }
+        std::unique_ptr<ModuleSlotTracker> &optMst = MSTs[M];
+        if (!optMst) {
+          optMst = llvm::make_unique<ModuleSlotTracker>(M);
+        }
+        MST = optMst.get();
       }
-      MST = optMst.get();
-    }
 
-    const Value *V = It->second.Value;
-    bool IsSentinel = Sentinel && V == Sentinel.get();
-
-    if (const BasicBlock *BB = dyn_cast<BasicBlock>(Key)) {
-      dbgs() << "[BB]";
-      BB->printAsOperand(dbgs(), false, *MST);
-      dbgs() << " -> ";
-      if (IsSentinel)
-        dbgs() << "NO_VALUE";
-      else {
-        if (IsConstantTrue(V))
-          dbgs() << "Always Reachable!";
-        else if (IsConstantFalse(V))
-          dbgs() << "Never Reachable!";
+      const Value *V = It->second.Value;
+      bool IsSentinel = Sentinel && V == Sentinel.get();
+
+      if (const BasicBlock *BB = dyn_cast<BasicBlock>(Key)) {
+        dbgs() << "[BB]";
+        BB->printAsOperand(dbgs(), false, *MST);
+        dbgs() << " -> ";
+        if (IsSentinel)
+          dbgs() << "NO_VALUE";
+        else {
+          if (IsConstantTrue(V))
+            dbgs() << "Always Reachable!";
+          else if (IsConstantFalse(V))
+            dbgs() << "Never Reachable!";
+        }
+      } else {
+        dbgs() << *Key << " -> ";
+        if (IsSentinel)
+          dbgs() << "NO_VALUE";
+        else
+          dbgs() << *V;
       }
-    } else {
-      dbgs() << *Key << " -> ";
-      if (IsSentinel)
-        dbgs() << "NO_VALUE";
-      else
-        dbgs() << *V;
+      dbgs() << "\n";
     }
-    dbgs() << "\n";
   }
 }
 
 void DxilValueCache::WeakValueMap::Set(Value *Key, Value *V) {
-  Map[Key].Set(Key, V);
+  GetOrCreate(Key).Set(Key, V);
 }
 
 // If there's a cached value, return it. Otherwise, return
@@ -485,13 +519,13 @@ Value *DxilValueCache::GetValue(Value *V, DominatorTree *DT) {
 }
 
 Constant *DxilValueCache::GetConstValue(Value *V, DominatorTree *DT) {
-  if (Value *NewV = GetValue(V))
+  if (Value *NewV = GetValue(V, DT))
     return dyn_cast<Constant>(NewV);
   return nullptr;
 }
 
 ConstantInt *DxilValueCache::GetConstInt(Value *V, DominatorTree *DT) {
-  if (Value *NewV = GetValue(V))
+  if (Value *NewV = GetValue(V, DT))
     return dyn_cast<ConstantInt>(NewV);
   return nullptr;
 }
@@ -4803,7 +4803,10 @@ OutOfRecordLoop:
   // Trim the value list down to the size it was before we parsed this function.
   ValueList.shrinkTo(ModuleValueListSize);
   MDValueList.shrinkTo(ModuleMDValueListSize);
-  std::vector<BasicBlock*>().swap(FunctionBBs);
+  // HLSL Change Starts - keep the block table's storage for the next function
+  // body; libraries materialize thousands of functions back to back.
+  FunctionBBs.clear();
+  // HLSL Change Ends
   return std::error_code();
 }
 
@@ -968,8 +968,9 @@ static void ConvertUsedResource(std::unordered_set<unsigned> &immResID,
 void DxilModule::RemoveFunction(llvm::Function *F) {
   DXASSERT_NOMSG(F != nullptr);
   m_DxilEntryPropsMap.erase(F);
-  if (m_pTypeSystem.get()->GetFunctionAnnotation(F))
-    m_pTypeSystem.get()->EraseFunctionAnnotation(F);
+  DxilTypeSystem &TypeSys = GetTypeSystem();
+  if (TypeSys.GetFunctionAnnotation(F))
+    TypeSys.EraseFunctionAnnotation(F);
   m_pOP->RemoveFunction(F);
 }
 
@@ -1315,9 +1316,13 @@ void DxilModule::ResetSerializedRootSignature(std::vector<uint8_t> &Value) {
   m_SerializedRootSignature.assign(Value.begin(), Value.end());
 }
 
-DxilTypeSystem &DxilModule::GetTypeSystem() { return *m_pTypeSystem; }
+DxilTypeSystem &DxilModule::GetTypeSystem() {
+  LoadPendingTypeSystem();
+  return *m_pTypeSystem;
+}
 
 const DxilTypeSystem &DxilModule::GetTypeSystem() const {
+  LoadPendingTypeSystem();
   return *m_pTypeSystem;
 }
 
@@ -1329,6 +1334,7 @@ const std::vector<unsigned> &DxilModule::GetSerializedViewIdState() const {
 }
 
 void DxilModule::ResetTypeSystem(DxilTypeSystem *pValue) {
+  m_bTypeSystemLoadPending = false;
   m_pTypeSystem.reset(pValue);
 }
 
@@ -1398,6 +1404,12 @@ void DxilModule::ClearDxilMetadata(Module &M) {
   // root signature, function properties.
   // Other cases for libs pending.
   // LLVM used is a global variable - handle separately.
+
+  // Deferred type annotations only exist as metadata; decode them before
+  // that metadata goes away.
+  if (M.HasDxilModule())
+    M.GetDxilModule().LoadPendingTypeSystem();
+
   SmallVector<NamedMDNode *, 8> nodes;
   for (NamedMDNode &b : M.named_metadata()) {
     StringRef name = b.getName();
@@ -1513,9 +1525,12 @@ bool DxilModule::IsKnownNamedMetaData(llvm::NamedMDNode &Node) {
   return DxilMDHelper::IsKnownNamedMetaData(Node);
 }
 
-bool DxilModule::HasMetadataErrors() { return m_bMetadataErrors; }
+bool DxilModule::HasMetadataErrors() {
+  LoadPendingTypeSystem();
+  return m_bMetadataErrors;
+}
 
-void DxilModule::LoadDxilMetadata() {
+void DxilModule::LoadDxilMetadata(bool bLazyTypeSystem) {
   m_bMetadataErrors = false;
   m_pMDHelper->LoadValidatorVersion(m_ValMajor, m_ValMinor);
   const ShaderModel *loadedSM;
@@ -1609,6 +1624,27 @@ void DxilModule::LoadDxilMetadata() {
 
   LoadDxilResources(*pEntryResources);
 
+  // Type annotations are the bulk of library metadata; leave them for the
+  // first GetTypeSystem() call when asked to.
+  m_bTypeSystemLoadPending = bLazyTypeSystem;
+  if (!bLazyTypeSystem)
+    LoadDxilTypeSystem();
+
+  m_pMDHelper->LoadRootSignature(m_SerializedRootSignature);
+
+  m_pMDHelper->LoadDxilViewIdState(m_SerializedState);
+
+  m_bMetadataErrors |= m_pMDHelper->HasExtraMetadata();
+}
+
+void DxilModule::LoadPendingTypeSystem() const {
+  if (m_bTypeSystemLoadPending)
+    const_cast<DxilModule *>(this)->LoadDxilTypeSystem();
+}
+
+void DxilModule::LoadDxilTypeSystem() {
+  m_bTypeSystemLoadPending = false;
+
   // Type system is not required for consumption of dxil.
   try {
     m_pMDHelper->LoadDxilTypeSystem(*m_pTypeSystem.get());
@@ -1632,10 +1668,6 @@ void DxilModule::LoadDxilMetadata() {
     m_pTypeSystem->GetPayloadAnnotationMap().clear();
   }
 
-  m_pMDHelper->LoadRootSignature(m_SerializedRootSignature);
-
-  m_pMDHelper->LoadDxilViewIdState(m_SerializedState);
-
   m_bMetadataErrors |= m_pMDHelper->HasExtraMetadata();
 }
 
@@ -1794,7 +1826,7 @@ bool DxilModule::StripReflection() {
                                  containedStructs.end());
     }
 
-    m_pTypeSystem->GetStructAnnotationMap().remove_if(
+    GetTypeSystem().GetStructAnnotationMap().remove_if(
         [structsToKeep](
             const std::pair<const StructType *,
                             std::unique_ptr<DxilStructAnnotation>> &I) {
@@ -1802,14 +1834,15 @@ bool DxilModule::StripReflection() {
         });
   } else {
     // Remove struct annotations.
-    if (!m_pTypeSystem->GetStructAnnotationMap().empty()) {
-      m_pTypeSystem->GetStructAnnotationMap().clear();
+    DxilTypeSystem &TypeSys = GetTypeSystem();
+    if (!TypeSys.GetStructAnnotationMap().empty()) {
+      TypeSys.GetStructAnnotationMap().clear();
       bChanged = true;
     }
     if (DXIL::CompareVersions(m_ValMajor, m_ValMinor, 1, 5) >= 0) {
       // Remove function annotations.
-      if (!m_pTypeSystem->GetFunctionAnnotationMap().empty()) {
-        m_pTypeSystem->GetFunctionAnnotationMap().clear();
+      if (!TypeSys.GetFunctionAnnotationMap().empty()) {
+        TypeSys.GetFunctionAnnotationMap().clear();
         bChanged = true;
       }
     }
@@ -1873,7 +1906,7 @@ static void RemoveUsedTypesFromSet(std::vector<std::unique_ptr<TResource>> &vec,
 void DxilModule::RemoveUnusedTypeAnnotations() {
   // Collect annotated types
   const DxilTypeSystem::StructAnnotationMap &SAMap =
-      m_pTypeSystem->GetStructAnnotationMap();
+      GetTypeSystem().GetStructAnnotationMap();
   SetVector<const StructType *> types;
   for (const auto &it : SAMap)
     types.insert(it.first);
@@ -1894,7 +1927,7 @@ void DxilModule::RemoveUnusedTypeAnnotations() {
 
   // Remove remaining set of types
   for (const StructType *ST : types)
-    m_pTypeSystem->EraseStructAnnotation(ST);
+    GetTypeSystem().EraseStructAnnotation(ST);
 }
 
 template <typename _T>
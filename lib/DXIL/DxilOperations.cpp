@@ -4281,10 +4281,9 @@ Function *OP::GetOpFunc(OpCode opCode, Type *pOverloadType) {
   OpCodeClass opClass = OpProps.opCodeClass;
   Function *&F =
       m_OpCodeClassCache[(unsigned)opClass].pOverloads[pOverloadType];
-  if (F != nullptr) {
-    UpdateCache(opClass, pOverloadType, F);
+  // UpdateCache already recorded F in both maps when it was first returned.
+  if (F != nullptr)
     return F;
-  }
 
   SmallVector<Type *, 32> ArgTypes; // RetType is ArgTypes[0]
   Type *pETy = pOverloadType;
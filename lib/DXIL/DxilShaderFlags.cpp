@@ -335,8 +335,8 @@ struct ResKeyHash {
 // indexed by space, class, lower, and upper bounds
 DxilResource *GetResourceFromAnnotateHandle(
     const hlsl::DxilModule *M, CallInst *handleCall,
-    std::unordered_map<ResourceKey, DxilResource *, ResKeyHash, ResKeyEq>
-        resMap) {
+    const std::unordered_map<ResourceKey, DxilResource *, ResKeyHash, ResKeyEq>
+        &resMap) {
   DxilResource *resource = nullptr;
 
   ConstantInt *HandleOpCodeConst = cast<ConstantInt>(
@@ -356,7 +356,9 @@ DxilResource *GetResourceFromAnnotateHandle(
           *cast<Constant>(fromBind.get_bind()));
       ResourceKey key = {B.resourceClass, B.spaceID, B.rangeLowerBound,
                          B.rangeUpperBound};
-      resource = resMap[key];
+      auto it = resMap.find(key);
+      if (it != resMap.end())
+        resource = it->second;
     } else if (handleOp == DXIL::OpCode::CreateHandleForLib) {
       // If library handle, find DxilResource by checking the name
       if (LoadInst *LI = dyn_cast<LoadInst>(createCall->getArgOperand(
@@ -495,21 +497,36 @@ ShaderFlags ShaderFlags::CollectShaderFlags(const Function *F,
   bool hasWriteableMSAATextures_1_7 = false;
   bool hasWriteableMSAATextures = false;
 
-  // Set up resource to binding handle map for 64-bit atomics usage
-  std::unordered_map<ResourceKey, DxilResource *, ResKeyHash, ResKeyEq> resMap;
-  for (auto &res : M->GetUAVs()) {
-    ResourceKey key = {(uint8_t)res->GetClass(), res->GetSpaceID(),
-                       res->GetLowerBound(), res->GetUpperBound()};
-    resMap.insert({key, res.get()});
-
-    // The flag was set for this function if any RWTexture2DMS[Array] resources
-    // existed in the module.  Now, for compatibility, we need to track this
-    // flag so we can set it if validator version is < 1.8.
-    if (res->GetKind() == DXIL::ResourceKind::Texture2DMS ||
-        res->GetKind() == DXIL::ResourceKind::Texture2DMSArray)
-      hasWriteableMSAATextures_1_7 = true;
+  // The flag was set for this function if any RWTexture2DMS[Array] resources
+  // existed in the module.  Now, for compatibility, we need to track this
+  // flag so we can set it if validator version is < 1.8.
+  if (setWriteableMSAATextures_1_7) {
+    for (auto &res : M->GetUAVs()) {
+      if (res->GetKind() == DXIL::ResourceKind::Texture2DMS ||
+          res->GetKind() == DXIL::ResourceKind::Texture2DMSArray) {
+        hasWriteableMSAATextures_1_7 = true;
+        break;
+      }
+    }
   }
 
+  // Resource to binding handle map for 64-bit atomics usage.  This runs for
+  // every function in the module, so only build it once a function actually
+  // uses a 64-bit atomic.
+  std::unordered_map<ResourceKey, DxilResource *, ResKeyHash, ResKeyEq> resMap;
+  bool resMapBuilt = false;
+  auto getResMap = [&]() -> const decltype(resMap) & {
+    if (!resMapBuilt) {
+      for (auto &res : M->GetUAVs()) {
+        ResourceKey key = {(uint8_t)res->GetClass(), res->GetSpaceID(),
+                           res->GetLowerBound(), res->GetUpperBound()};
+        resMap.insert({key, res.get()});
+      }
+      resMapBuilt = true;
+    }
+    return resMap;
+  };
+
   auto checkUsedResourceProps = [&](DxilResourceProperties RP) {
     if (hasUAVs && hasWriteableMSAATextures)
       return;
@@ -657,8 +674,8 @@ ShaderFlags ShaderFlags::CollectShaderFlags(const Function *F,
             if (DXIL::IsTyped(RP.getResourceKind()))
               hasAtomicInt64OnTypedResource = true;
             // set uses 64-bit flag if relevant
-            if (DxilResource *res =
-                    GetResourceFromAnnotateHandle(M, handleCall, resMap)) {
+            if (DxilResource *res = GetResourceFromAnnotateHandle(
+                    M, handleCall, getResMap())) {
               res->SetHasAtomic64Use(true);
             } else {
               // Assuming CreateHandleFromHeap, which indicates a descriptor
@@ -811,6 +811,13 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
 
   opts.DisableValidation = Args.hasFlag(OPT_VD, OPT_INVALID, false);
 
+  // Reflection depends on the optimization level (dead code can keep a
+  // resource bound), so -reflect-only keeps the requested level. It skips
+  // validation and, in the compiler, container assembly.
+  opts.ReflectOnly = Args.hasFlag(OPT_reflect_only, OPT_INVALID, false);
+  if (opts.ReflectOnly)
+    opts.DisableValidation = true;
+
   opts.AllResourcesBound =
       Args.hasFlag(OPT_all_resources_bound, OPT_INVALID, false);
   opts.AllResourcesBound = Args.hasFlag(OPT_all_resources_bound_, OPT_INVALID,
@@ -821,6 +828,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
   opts.DefaultRowMajor = Args.hasFlag(OPT_Zpr, OPT_INVALID, false);
   opts.DefaultColMajor = Args.hasFlag(OPT_Zpc, OPT_INVALID, false);
   opts.DumpBin = Args.hasFlag(OPT_dumpbin, OPT_INVALID, false);
+  opts.Batch = Args.hasFlag(OPT_batch, OPT_INVALID, false);
   opts.Link = Args.hasFlag(OPT_link, OPT_INVALID, false);
   bool NotUseLegacyCBufLoad =
       Args.hasFlag(OPT_no_legacy_cbuf_layout, OPT_INVALID, false);
@@ -837,6 +845,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
   opts.PackOptimized = Args.hasFlag(OPT_pack_optimized, OPT_INVALID, false);
   opts.PackOptimized =
       Args.hasFlag(OPT_pack_optimized_, OPT_INVALID, opts.PackOptimized);
+  opts.PackMinimal = Args.hasFlag(OPT_pack_minimal, OPT_INVALID, false);
   opts.DisplayIncludeProcess = Args.hasFlag(OPT_H, OPT_INVALID, false);
   opts.WarningAsError = Args.hasFlag(OPT__SLASH_WX, OPT_INVALID, false);
   opts.AvoidFlowControl = Args.hasFlag(OPT_Gfa, OPT_INVALID, false);
@@ -873,6 +882,26 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
   opts.ResMayAlias = Args.hasFlag(OPT_res_may_alias, OPT_INVALID, false);
   opts.ResMayAlias =
       Args.hasFlag(OPT_res_may_alias_, OPT_INVALID, opts.ResMayAlias);
+  opts.FreeFrontendEarly =
+      Args.hasFlag(OPT_free_frontend_early, OPT_INVALID, false);
+  opts.MemoryBudgetKB = 0;
+  if (Arg *A = Args.getLastArg(OPT_memory_budget)) {
+    // Megabytes, or kilobytes with a K suffix.
+    llvm::StringRef Budget = A->getValue();
+    bool IsKB = Budget.endswith("K") || Budget.endswith("k");
+    if (IsKB)
+      Budget = Budget.drop_back();
+    if (Budget.getAsInteger(10, opts.MemoryBudgetKB) ||
+        opts.MemoryBudgetKB == 0 ||
+        (!IsKB && opts.MemoryBudgetKB > (UINT_MAX >> 10))) {
+      errors << "Unsupported value '" << A->getValue()
+             << "' for memory budget, expected a positive number of "
+                "megabytes, or of kilobytes with a K suffix.";
+      return 1;
+    }
+    if (!IsKB)
+      opts.MemoryBudgetKB <<= 10;
+  }
   opts.ForceZeroStoreLifetimes =
       Args.hasFlag(OPT_force_zero_store_lifetimes, OPT_INVALID, false);
   // Lifetime markers on by default in 6.6 unless disabled explicitly
@@ -938,6 +967,11 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
               "together, use /? to get usage information";
     return 1;
   }
+  if (opts.PackMinimal && (opts.PackPrefixStable || opts.PackOptimized)) {
+    errors << "Cannot specify /pack-minimal with /pack_prefix_stable or "
+              "/pack_optimized, use /? to get usage information";
+    return 1;
+  }
   // TODO: more fxc option check.
   // ERR_RES_MAY_ALIAS_ONLY_IN_CS_5
   // ERR_NOT_ABLE_TO_FLATTEN on if that contain side effects
@@ -1014,7 +1048,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
   if ((flagsToInclude & hlsl::options::DriverOption) &&
       !(flagsToInclude & hlsl::options::RewriteOption) &&
       opts.TargetProfile.empty() && !opts.DumpBin && opts.Preprocess.empty() &&
-      !opts.RecompileFromBinary) {
+      !opts.RecompileFromBinary && !opts.Batch) {
     // Target profile is required in arguments only for drivers when compiling;
     // APIs take this through an argument.
     errors << "Target profile argument is missing";
@@ -1181,6 +1215,8 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
 
   opts.SpirvOptions.printAll =
       Args.hasFlag(OPT_fspv_print_all, OPT_INVALID, false);
+  opts.SpirvOptions.fuseOptimizerPasses =
+      Args.hasFlag(OPT_fspv_fuse_optimizer_passes, OPT_INVALID, false);
 
   opts.SpirvOptions.debugInfoFile = opts.SpirvOptions.debugInfoSource = false;
   opts.SpirvOptions.debugInfoLine = opts.SpirvOptions.debugInfoTool = false;
@@ -1298,6 +1334,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
       Args.hasFlag(OPT_fspv_reflect, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_fix_func_call_arguments, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_print_all, OPT_INVALID, false) ||
+      Args.hasFlag(OPT_fspv_fuse_optimizer_passes, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_use_emulated_heap, OPT_INVALID, false) ||
       Args.hasFlag(OPT_fspv_use_descriptor_heap, OPT_INVALID, false) ||
       Args.hasFlag(OPT_Wno_vk_ignored_features, OPT_INVALID, false) ||
@@ -1352,6 +1389,24 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
     return 1;
   }
 
+  if (opts.ReflectOnly) {
+    if (opts.DebugInfo || opts.SourceOnlyDebug) {
+      errors << "-reflect-only cannot be used together with /Zi or /Zs";
+      return 1;
+    }
+    if (opts.StripReflection || opts.CodeGenHighLevel || opts.GenMetal) {
+      errors << "-reflect-only cannot be used together with "
+                "-Qstrip_reflect, -fcgl or -metal";
+      return 1;
+    }
+#ifdef ENABLE_SPIRV_CODEGEN
+    if (opts.GenSPIRV) {
+      errors << "-reflect-only cannot be used together with -spirv";
+      return 1;
+    }
+#endif
+  }
+
   if (opts.SourceInDebugModule && opts.SourceOnlyDebug) {
     errors << "Cannot specify both /Qsource_in_debug_module and /Zs";
     return 1;
@@ -16,6 +16,12 @@
 #if defined(_WIN32) && !defined(DXC_DISABLE_ALLOCATOR_OVERRIDES)
 // CoGetMalloc from combaseapi.h is used
 #else
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
 struct DxcCoMalloc : public IMalloc {
   DxcCoMalloc() : m_dwRef(0){};
 
@@ -30,7 +36,19 @@ struct DxcCoMalloc : public IMalloc {
     return realloc(ptr, size);
   }
   void STDMETHODCALLTYPE Free(void *ptr) override { free(ptr); }
-  SIZE_T STDMETHODCALLTYPE GetSize(void *pv) override { return -1; }
+  SIZE_T STDMETHODCALLTYPE GetSize(void *pv) override {
+    // Match CoTaskMem semantics: -1 for a null pointer. The usable size may
+    // be larger than what was requested, which is fine for accounting.
+    if (pv == nullptr)
+      return (SIZE_T)-1;
+#if defined(_WIN32)
+    return _msize(pv);
+#elif defined(__APPLE__)
+    return malloc_size(pv);
+#else
+    return malloc_usable_size(pv);
+#endif
+  }
   int STDMETHODCALLTYPE DidAlloc(void *pv) override { return -1; }
   void STDMETHODCALLTYPE HeapMinimize(void) override {}
 
@@ -5,7 +5,7 @@
 // This file is distributed under the University of Illinois Open Source     //
 // License. See LICENSE.TXT for details.                                     //
 //                                                                           //
-// Provides support for a thread-local allocator.                            //
+// Provides support for a thread-local allocator and a budgeted allocator.   //
 //                                                                           //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -16,7 +16,9 @@
 
 #include "dxc/Support/WinFunctions.h"
 #include "dxc/Support/WinIncludes.h"
+#include "dxc/Support/dxcmem.h"
 #include "llvm/Support/ThreadLocal.h"
+#include "llvm/Support/raw_ostream.h"
 #include <memory>
 
 static llvm::sys::ThreadLocal<IMalloc> *g_ThreadMallocTls;
@@ -134,4 +136,114 @@ void DxcDelete(void *ptr) throw() {
     // CoGetMalloc, Free & Release for better perf.
     CoTaskMemFree(ptr);
   }
-}
\ No newline at end of file
+}
+
+DxcBudgetMalloc::DxcBudgetMalloc(IMalloc *pMalloc, uint64_t budget)
+    : m_dwRef(0), m_pMalloc(pMalloc), m_Budget(budget), m_Live(0),
+      m_Phase(PhaseSetup), m_ExceededPhase(-1) {
+  for (std::atomic<int64_t> &peak : m_Peak)
+    peak.store(0);
+}
+
+int64_t DxcBudgetMalloc::SizeOf(void *pv) {
+  SIZE_T size = m_pMalloc->GetSize(pv);
+  return size == (SIZE_T)-1 ? 0 : (int64_t)size;
+}
+
+// Blocks allocated before the budget was installed may be freed through it,
+// so the running total can dip below zero; treat that as empty.
+bool DxcBudgetMalloc::WouldExceed(uint64_t size) {
+  int64_t live = m_Live.load(std::memory_order_relaxed);
+  if ((live > 0 ? (uint64_t)live : 0) + size <= m_Budget)
+    return false;
+  int none = -1;
+  m_ExceededPhase.compare_exchange_strong(none, (int)m_Phase.load());
+  return true;
+}
+
+void DxcBudgetMalloc::UpdatePeak(int64_t live) {
+  std::atomic<int64_t> &peak = m_Peak[m_Phase.load()];
+  int64_t prior = peak.load(std::memory_order_relaxed);
+  while (live > prior && !peak.compare_exchange_weak(prior, live))
+    ;
+}
+
+void DxcBudgetMalloc::Track(int64_t delta) {
+  int64_t live = m_Live.fetch_add(delta, std::memory_order_relaxed) + delta;
+  if (delta > 0)
+    UpdatePeak(live);
+}
+
+bool DxcBudgetMalloc::CanTrack(IMalloc *pMalloc) {
+  void *pv = pMalloc->Alloc(1);
+  if (pv == nullptr)
+    return false;
+  SIZE_T size = pMalloc->GetSize(pv);
+  pMalloc->Free(pv);
+  return size != (SIZE_T)-1 && size != 0;
+}
+
+const char *DxcBudgetMalloc::GetPhaseName(unsigned phase) {
+  switch (phase) {
+  case PhaseSetup:
+    return "setup";
+  case PhaseFrontend:
+    return "parsing, code generation and optimization";
+  case PhaseContainer:
+    return "validation and container assembly";
+  case PhaseDebugInfo:
+    return "debug info generation";
+  }
+  return "unknown phase";
+}
+
+void DxcBudgetMalloc::SetPhase(Phase phase) {
+  m_Phase = phase;
+  // Whatever is still live from earlier phases counts toward this one.
+  UpdatePeak(m_Live.load(std::memory_order_relaxed));
+}
+
+void DxcBudgetMalloc::WriteBudget(llvm::raw_ostream &OS) const {
+  if (m_Budget % (1 << 20) == 0)
+    OS << (m_Budget >> 20) << " MB";
+  else
+    OS << (m_Budget >> 10) << " KB";
+}
+
+void DxcBudgetMalloc::WritePeaks(llvm::raw_ostream &OS) const {
+  OS << "Peak memory by phase (budget ";
+  WriteBudget(OS);
+  OS << "):\n";
+  for (unsigned phase = 0; phase < PhaseCount; ++phase) {
+    int64_t peak = m_Peak[phase].load();
+    OS << "  " << GetPhaseName(phase) << ": " << (peak > 0 ? peak : 0)
+       << " bytes\n";
+  }
+}
+
+void *STDMETHODCALLTYPE DxcBudgetMalloc::Alloc(SIZE_T cb) {
+  if (WouldExceed(cb))
+    return nullptr;
+  void *pv = m_pMalloc->Alloc(cb);
+  if (pv)
+    Track(SizeOf(pv));
+  return pv;
+}
+
+void *STDMETHODCALLTYPE DxcBudgetMalloc::Realloc(void *pv, SIZE_T cb) {
+  int64_t priorSize = pv ? SizeOf(pv) : 0;
+  if ((int64_t)cb > priorSize && WouldExceed(cb - priorSize))
+    return nullptr;
+  void *R = m_pMalloc->Realloc(pv, cb);
+  if (R)
+    Track(SizeOf(R) - priorSize);
+  else if (cb == 0)
+    Track(-priorSize);
+  return R;
+}
+
+void STDMETHODCALLTYPE DxcBudgetMalloc::Free(void *pv) {
+  if (pv)
+    Track(-SizeOf(pv));
+  m_pMalloc->Free(pv);
+}
@@ -1899,6 +1899,63 @@ void hlsl::StripAndCreateReflectionStream(
   *ppReflectionStreamOut = pReflectionBitcodeStream.Detach();
 }
 
+// Write the reflection part, and the RDAT part for libraries, as the separate
+// reflection output.
+static void WriteReflectionStream(const ShaderModel *pSM,
+                                  AbstractMemoryStream *pReflectionBitcode,
+                                  uint32_t reflectPartSizeInBytes,
+                                  DxilRDATWriter *pRDATWriter,
+                                  AbstractMemoryStream *pReflectionStreamOut) {
+  DxilPartHeader partSTAT;
+  partSTAT.PartFourCC = DFCC_ShaderStatistics;
+  partSTAT.PartSize = reflectPartSizeInBytes;
+  IFT(WriteStreamValue(pReflectionStreamOut, partSTAT));
+  WriteProgramPart(pSM, pReflectionBitcode, pReflectionStreamOut);
+
+  // If library, we need RDAT part as well.  For now, we just append it
+  if (pSM->IsLib()) {
+    DxilPartHeader partRDAT;
+    partRDAT.PartFourCC = DFCC_RuntimeData;
+    partRDAT.PartSize = pRDATWriter->size();
+    IFT(WriteStreamValue(pReflectionStreamOut, partRDAT));
+    pRDATWriter->write(pReflectionStreamOut);
+  }
+}
+
+void hlsl::SerializeDxilReflectionForModule(
+    DxilModule *pModule, AbstractMemoryStream *pReflectionStreamOut) {
+  llvm::TimeTraceScope TimeScope("SerializeDxilReflection", StringRef(""));
+  DXASSERT_NOMSG(pModule != nullptr);
+  DXASSERT_NOMSG(pReflectionStreamOut != nullptr);
+
+  // Strip the module the way SerializeDxilContainerForModule does before it
+  // clones it for reflection, so both produce the same reflection part.
+  std::unique_ptr<DxilRDATWriter> pRDATWriter = nullptr;
+  if (pModule->GetShaderModel()->IsLib()) {
+    pRDATWriter = llvm::make_unique<DxilRDATWriter>(*pModule);
+    pModule->StripSubobjectsFromMetadata();
+    pModule->ResetSubobjects(nullptr);
+  } else if (!pModule->GetSerializedRootSignature().empty()) {
+    pModule->GetSerializedRootSignature().clear();
+    pModule->StripRootSignatureFromMetadata();
+  }
+  if (HasDebugInfoOrLineNumbers(*pModule->GetModule())) {
+    llvm::StripDebugInfo(*pModule->GetModule());
+    pModule->StripDebugRelatedCode();
+  }
+
+  uint32_t reflectPartSizeInBytes = 0;
+  CComPtr<AbstractMemoryStream> pReflectionBitcodeStream;
+  std::unique_ptr<Module> reflectionModule =
+      CloneModuleForReflection(pModule->GetModule());
+  hlsl::StripAndCreateReflectionStream(reflectionModule.get(),
+                                       &reflectPartSizeInBytes,
+                                       &pReflectionBitcodeStream);
+  WriteReflectionStream(pModule->GetShaderModel(), pReflectionBitcodeStream,
+                        reflectPartSizeInBytes, pRDATWriter.get(),
+                        pReflectionStreamOut);
+}
+
 void hlsl::SerializeDxilContainerForModule(
     DxilModule *pModule, AbstractMemoryStream *pModuleBitcode,
     IDxcVersionInfo *DXCVersionInfo, AbstractMemoryStream *pFinalStream,
@@ -2090,23 +2147,10 @@ void hlsl::SerializeDxilContainerForModule(
                                          &pReflectionBitcodeStream);
   }
 
-  if (pReflectionStreamOut) {
-    DxilPartHeader partSTAT;
-    partSTAT.PartFourCC = DFCC_ShaderStatistics;
-    partSTAT.PartSize = reflectPartSizeInBytes;
-    IFT(WriteStreamValue(pReflectionStreamOut, partSTAT));
-    WriteProgramPart(pModule->GetShaderModel(), pReflectionBitcodeStream,
-                     pReflectionStreamOut);
-
-    // If library, we need RDAT part as well.  For now, we just append it
-    if (pModule->GetShaderModel()->IsLib()) {
-      DxilPartHeader partRDAT;
-      partRDAT.PartFourCC = DFCC_RuntimeData;
-      partRDAT.PartSize = pRDATWriter->size();
-      IFT(WriteStreamValue(pReflectionStreamOut, partRDAT));
-      pRDATWriter->write(pReflectionStreamOut);
-    }
-  }
+  if (pReflectionStreamOut)
+    WriteReflectionStream(pModule->GetShaderModel(), pReflectionBitcodeStream,
+                          reflectPartSizeInBytes, pRDATWriter.get(),
+                          pReflectionStreamOut);
 
   if (Flags & SerializeDxilFlags::IncludeReflectionPart) {
     writer.AddPart(
@@ -38,8 +38,9 @@ void dxil_dia::Session::Init(std::shared_ptr<llvm::LLVMContext> context,
   m_finder = finder;
   m_dxilModule = llvm::make_unique<hlsl::DxilModule>(mod.get());
 
-  // Extract HLSL metadata.
-  m_dxilModule->LoadDxilMetadata();
+  // Extract HLSL metadata. Symbol queries don't need type annotations, so
+  // leave those undecoded unless something asks for the type system.
+  m_dxilModule->LoadDxilMetadata(/*bLazyTypeSystem*/ true);
 
   // Get file contents.
   m_contents =
@@ -940,6 +940,49 @@ bool VerifyRootSignatureWithShaderPSV(
   return true;
 }
 
+bool VerifyRootSignatureWithShaderPSVs(
+    const DxilVersionedRootSignatureDesc *pDesc, uint32_t NumShaders,
+    const DXIL::ShaderKind *pShaderKinds, const void *const *ppPSVData,
+    const uint32_t *pPSVSizes, bool *pResults, llvm::raw_ostream &DiagStream) {
+  for (uint32_t i = 0; i < NumShaders; i++)
+    pResults[i] = false;
+
+  RootSignatureVerifier RSV;
+  DiagnosticPrinterRawOStream DiagPrinter(DiagStream);
+  try {
+    RSV.VerifyRootSignature(pDesc, DiagPrinter);
+  } catch (...) {
+    return false;
+  }
+
+  // VerifyShader only reads the register ranges accumulated above, so the
+  // same verifier can be reused for every shader.
+  bool bAllCompatible = true;
+  for (uint32_t i = 0; i < NumShaders; i++) {
+    std::string ShaderDiags;
+    llvm::raw_string_ostream ShaderOS(ShaderDiags);
+    DiagnosticPrinterRawOStream ShaderPrinter(ShaderOS);
+    try {
+      RSV.VerifyShader(GetVisibilityType(pShaderKinds[i]), ppPSVData[i],
+                       pPSVSizes[i], ShaderPrinter);
+      pResults[i] = true;
+    } catch (...) {
+      bAllCompatible = false;
+    }
+
+    // Prefix each message with the shader index so the caller can tell which
+    // shader it belongs to.
+    llvm::StringRef Rest(ShaderOS.str());
+    while (!Rest.empty()) {
+      std::pair<llvm::StringRef, llvm::StringRef> Line = Rest.split('\n');
+      DiagStream << "shader " << i << ": " << Line.first << "\n";
+      Rest = Line.second;
+    }
+  }
+
+  return bAllCompatible;
+}
+
 bool VerifyRootSignature(const DxilVersionedRootSignatureDesc *pDesc,
                          llvm::raw_ostream &DiagStream,
                          bool bAllowReservedRegisterSpace) {
@@ -31,7 +31,7 @@ LiveValues::LiveValues(ArrayRef<Instruction *> computeLiveAt) {
     Instruction *v = computeLiveAt[i];
     m_computeLiveAtIndex.insert(std::make_pair(v, i));
 
-    m_activeBlocks.insert(v->getParent());
+    m_blockIndices[v->getParent()].push_back(i);
   }
 
   if (computeLiveAt.size() > 0) {
@@ -45,21 +45,35 @@ void LiveValues::markLiveRange(Instruction *value, BasicBlock::iterator begin,
                                BasicBlock::iterator end) {
   BasicBlock *B = begin->getParent();
 
-  if (m_activeBlocks.count(B) == 0)
+  if (m_blockIndices.count(B) == 0)
     return; // Nothing to mark in this block
 
   for (BasicBlock::iterator I = begin; I != end; ++I) {
-    if (m_computeLiveAtIndex.count(I)) {
-      // Mark this value
-      unsigned int index = m_computeLiveAtIndex[I];
-      m_liveSets[index].insert(value);
-      m_allLiveSet.insert(value);
-      // Also store for each value where it is live.
-      m_liveAtIndices[value].insert(index);
-    }
+    auto it = m_computeLiveAtIndex.find(I);
+    if (it != m_computeLiveAtIndex.end())
+      markLiveAtIndex(value, it->second);
   }
 }
 
+// Mark the given value live for all code locations in the given block. This is
+// the common case for blocks between a definition and its uses, so use the
+// precomputed indices instead of walking the instructions.
+void LiveValues::markLiveBlock(Instruction *value, BasicBlock *B) {
+  auto it = m_blockIndices.find(B);
+  if (it == m_blockIndices.end())
+    return; // Nothing to mark in this block
+
+  for (unsigned int index : it->second)
+    markLiveAtIndex(value, index);
+}
+
+void LiveValues::markLiveAtIndex(Instruction *value, unsigned int index) {
+  m_liveSets[index].insert(value);
+  m_allLiveSet.insert(value);
+  // Also store for each value where it is live.
+  m_liveAtIndices[value].insert(index);
+}
+
 void LiveValues::upAndMark(Instruction *def, Use &use, BlockSet &scanned) {
   // Determine the starting point for the backwards search.
   // (Remember that Use represents an edge between the definition of a value and
@@ -155,7 +169,7 @@ void LiveValues::upAndMark(Instruction *def, Use &use, BlockSet &scanned) {
         // In this case mark the whole block as live range and don't come back
         // anymore.
         else {
-          markLiveRange(def, B->begin(), B->end());
+          markLiveBlock(def, B);
           scanned.insert(B);
         }
 
@@ -191,7 +205,7 @@ void LiveValues::upAndMark(Instruction *def, Use &use, BlockSet &scanned) {
       } else {
         // We are in an intermediate block on the way to the definition mark it,
         // all as live range.
-        markLiveRange(def, B->begin(), B->end());
+        markLiveBlock(def, B);
         scanned.insert(B);
       }
 
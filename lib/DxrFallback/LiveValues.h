@@ -70,13 +70,18 @@ private:
   llvm::Function *m_function = nullptr;
   std::vector<InstructionSetVector> m_liveSets;
   InstructionSetVector m_allLiveSet;
-  llvm::SmallSet<llvm::BasicBlock *, 8> m_activeBlocks;
   llvm::DenseMap<llvm::Instruction *, unsigned int> m_computeLiveAtIndex;
+  // For each block that contains computeLiveAt instructions, the indices of
+  // those instructions. Lets whole blocks be marked without scanning them.
+  llvm::DenseMap<llvm::BasicBlock *, llvm::SmallVector<unsigned int, 2>>
+      m_blockIndices;
   llvm::DenseMap<const llvm::Value *, Indices> m_liveAtIndices;
 
   typedef llvm::SmallSet<llvm::BasicBlock *, 8> BlockSet;
 
   void markLiveRange(llvm::Instruction *value, llvm::BasicBlock::iterator begin,
                      llvm::BasicBlock::iterator end);
+  void markLiveBlock(llvm::Instruction *value, llvm::BasicBlock *B);
+  void markLiveAtIndex(llvm::Instruction *value, unsigned int index);
   void upAndMark(llvm::Instruction *v, llvm::Use &use, BlockSet &scanned);
 };
@@ -14,10 +14,93 @@
 #include "dxc/DXIL/DxilSignature.h"
 #include "dxc/HLSL/DxilSignatureAllocator.h"
 #include "dxc/Support/Global.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
+
+#include <map>
 
 using namespace hlsl;
 using namespace llvm;
 
+namespace {
+// PackMinimal results, keyed by everything the allocator looks at, so shader
+// permutations with identical signatures don't repeat the search.
+typedef std::vector<unsigned> MinimalPackKey;
+struct MinimalPackResult {
+  std::vector<std::pair<unsigned, unsigned>> locations;
+  unsigned rowsUsed;
+};
+struct MinimalPackCache {
+  static const size_t kMaxEntries = 256;
+  sys::SmartMutex<true> lock;
+  std::map<MinimalPackKey, MinimalPackResult> results;
+};
+ManagedStatic<MinimalPackCache> MinimalPackResults;
+
+// alloc must be empty; elements must not be allocated yet.
+unsigned
+PackMinimalCached(DxilSignatureAllocator &alloc,
+                  std::vector<DxilSignatureAllocator::PackElement *> &elements,
+                  unsigned startRow, unsigned numRows) {
+  MinimalPackKey key;
+  key.reserve(4 + elements.size() * 7);
+  key.push_back(startRow);
+  key.push_back(numRows);
+  key.push_back(alloc.UseMinPrecision());
+  key.push_back(alloc.GetIgnoreIndexing());
+  for (auto &SE : elements) {
+    key.push_back(SE->GetID());
+    key.push_back((unsigned)SE->GetKind());
+    key.push_back((unsigned)SE->GetInterpolationMode());
+    key.push_back((unsigned)SE->GetInterpretation());
+    key.push_back((unsigned)SE->GetDataBitWidth());
+    key.push_back(SE->GetRows());
+    key.push_back(SE->GetCols());
+  }
+
+  MinimalPackCache &cache = *MinimalPackResults;
+  MinimalPackResult result;
+  bool found = false;
+  {
+    sys::SmartScopedLock<true> guard(cache.lock);
+    auto it = cache.results.find(key);
+    if (it != cache.results.end()) {
+      result = it->second;
+      found = true;
+    }
+  }
+
+  if (found) {
+    for (unsigned i = 0; i < elements.size(); ++i) {
+      unsigned row = result.locations[i].first;
+      unsigned col = result.locations[i].second;
+      if (row == (unsigned)-1)
+        continue;
+      alloc.PlaceElement(elements[i], row, col);
+      elements[i]->SetLocation(row, col);
+    }
+    return result.rowsUsed;
+  }
+
+  unsigned rowsUsed = alloc.PackMinimal(elements, startRow, numRows);
+  result.rowsUsed = rowsUsed;
+  result.locations.reserve(elements.size());
+  for (auto &SE : elements) {
+    if (SE->IsAllocated())
+      result.locations.emplace_back(SE->GetStartRow(), SE->GetStartCol());
+    else
+      result.locations.emplace_back((unsigned)-1, (unsigned)-1);
+  }
+  {
+    sys::SmartScopedLock<true> guard(cache.lock);
+    if (cache.results.size() >= MinimalPackCache::kMaxEntries)
+      cache.results.clear();
+    cache.results.emplace(std::move(key), std::move(result));
+  }
+  return rowsUsed;
+}
+} // namespace
+
 namespace hlsl {
 unsigned PackDxilSignature(DxilSignature &sig, DXIL::PackingStrategy packing) {
   unsigned rowsUsed = 0;
@@ -50,6 +133,9 @@ unsigned PackDxilSignature(DxilSignature &sig, DXIL::PackingStrategy packing) {
         case DXIL::PackingStrategy::Optimized:
           streamRowsUsed = alloc[i].PackOptimized(elements[i], 0, 32);
           break;
+        case DXIL::PackingStrategy::Minimal:
+          streamRowsUsed = PackMinimalCached(alloc[i], elements[i], 0, 32);
+          break;
         default:
           DXASSERT(false, "otherwise, invalid packing strategy supplied");
         }
@@ -93,6 +179,9 @@ unsigned PackDxilSignature(DxilSignature &sig, DXIL::PackingStrategy packing) {
     case DXIL::PackingStrategy::Optimized:
       rowsUsed = alloc.PackOptimized(elements, 0, 32);
       break;
+    case DXIL::PackingStrategy::Minimal:
+      rowsUsed = PackMinimalCached(alloc, elements, 0, 32);
+      break;
     default:
       DXASSERT(false, "otherwise, invalid packing strategy supplied");
     }
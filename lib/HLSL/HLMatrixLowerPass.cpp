@@ -1075,6 +1075,17 @@ Value *HLMatrixLowerPass::lowerHLMulIntrinsic(Value *Lhs, Value *Rhs,
       *m_pModule, MadFuncTy, HLOpcodeGroup::HLIntrinsic, (unsigned)MadOpcode);
   Constant *MadOpcodeVal = Builder.getInt32((unsigned)MadOpcode);
 
+  // Extract every operand element once up front. Each one feeds a whole
+  // row or column of the result, so extracting per multiply-add would
+  // create (LhsNumRows * RhsNumCols * AccCount) extracts per side.
+  SmallVector<Value *, 16> LhsElems, RhsElems;
+  for (unsigned i = 0, e = LhsNumRows * LhsNumCols; i != e; ++i)
+    LhsElems.push_back(
+        Builder.CreateExtractElement(LoweredLhs, static_cast<uint64_t>(i)));
+  for (unsigned i = 0, e = RhsNumRows * RhsNumCols; i != e; ++i)
+    RhsElems.push_back(
+        Builder.CreateExtractElement(LoweredRhs, static_cast<uint64_t>(i)));
+
   // Perform the multiplication!
   Value *Result =
       UndefValue::get(VectorType::get(ElemTy, LhsNumRows * RhsNumCols));
@@ -1091,10 +1102,8 @@ Value *HLMatrixLowerPass::lowerHLMulIntrinsic(Value *Lhs, Value *Rhs,
             ResultRowIdx, AccIdx, LhsNumRows, LhsNumCols);
         unsigned RhsElemIdx = HLMatrixType::getRowMajorIndex(
             AccIdx, ResultColIdx, RhsNumRows, RhsNumCols);
-        Value *LhsElem = Builder.CreateExtractElement(
-            LoweredLhs, static_cast<uint64_t>(LhsElemIdx));
-        Value *RhsElem = Builder.CreateExtractElement(
-            LoweredRhs, static_cast<uint64_t>(RhsElemIdx));
+        Value *LhsElem = LhsElems[LhsElemIdx];
+        Value *RhsElem = RhsElems[RhsElemIdx];
         if (ResultElem == nullptr) {
           ResultElem = ElemTy->isFloatingPointTy()
                            ? Builder.CreateFMul(LhsElem, RhsElem)
@@ -99,6 +99,10 @@ struct ClonedIteration {
   SetVector<BasicBlock *> Extended; // Blocks that are included in the clone
                                     // that are not in the core loop body.
   ClonedIteration() {}
+  // Presize VarMap for the given number of cloned values so it is not rehashed
+  // while the iteration is being cloned.
+  explicit ClonedIteration(unsigned NumValues)
+      : VarMap(NextPowerOf2(NumValues * 4 / 3 + 1)) {}
 };
 
 class DxilLoopUnroll : public LoopPass {
@@ -946,6 +950,17 @@ bool DxilLoopUnroll::runOnLoop(Loop *L, LPPassManager &LPM) {
       Iterations; // List of cloned iterations
   bool Succeeded = false;
 
+  // Number of values each iteration maps: the cloned blocks and their
+  // instructions.
+  unsigned NumClonedValues = 0;
+  for (BasicBlock *BB : ToBeCloned)
+    NumClonedValues += BB->size() + 1;
+
+  // If ScalarEvolution computed the trip count from the latch, every cloned
+  // iteration but the last is known to branch back to the header, so there is
+  // no need to ask DxilValueCache to fold each iteration's exit condition.
+  const bool HasExactTripCount = TripCount != 0 && ExitingBlock == Latch;
+
   unsigned MaxAttempt = this->MaxIterationAttempt;
   // If we were able to figure out the definitive trip count,
   // just unroll that many times.
@@ -960,7 +975,7 @@ bool DxilLoopUnroll::runOnLoop(Loop *L, LPPassManager &LPM) {
     ClonedIteration *PrevIteration = nullptr;
     if (Iterations.size())
       PrevIteration = Iterations.back().get();
-    Iterations.push_back(llvm::make_unique<ClonedIteration>());
+    Iterations.push_back(llvm::make_unique<ClonedIteration>(NumClonedValues));
     ClonedIteration &CurIteration = *Iterations.back().get();
 
     // Clone the blocks.
@@ -1063,8 +1078,10 @@ bool DxilLoopUnroll::runOnLoop(Loop *L, LPPassManager &LPM) {
     }
 
     // Check exit condition to see if we fully unrolled the loop
-    if (BranchInst *BI =
-            dyn_cast<BranchInst>(CurIteration.Latch->getTerminator())) {
+    BranchInst *LatchBI = nullptr;
+    if (!HasExactTripCount || IterationI + 1 >= TripCount)
+      LatchBI = dyn_cast<BranchInst>(CurIteration.Latch->getTerminator());
+    if (BranchInst *BI = LatchBI) {
       bool Cond = false;
 
       Value *ConstantCond = BI->getCondition();
@@ -353,7 +353,7 @@ static bool DeleteNonContributingValues(Function &F, DxilValueCache *DVC) {
 
   ValueDeleter Deleter;
 
-  DVC->ResetAll();
+  DVC->ResetFunction(&F);
   DVC->SetShouldSkipCallback(ShouldNotReplaceValue);
   bool Changed = Deleter.Run(F, DVC);
   DVC->SetShouldSkipCallback(nullptr);
@@ -51,6 +51,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Operator.h"
+#include "llvm/IR/ValueHandle.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -62,6 +63,7 @@
 #include "llvm/Transforms/Utils/PromoteMemToReg.h"
 #include "llvm/Transforms/Utils/SSAUpdater.h"
 #include <deque>
+#include <map>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
@@ -120,7 +122,13 @@ private:
   DxilTypeSystem &typeSys;
   const DataLayout &DL;
   DominatorTree *DT;
+  // Element GEPs created while rewriting OldVal, keyed by the element followed
+  // by the GEP indices. Identical field accesses share one GEP when it
+  // dominates the access being rewritten.
+  std::map<SmallVector<Value *, 8>, SmallVector<WeakVH, 2>> EltGEPs;
 
+  Value *GetOrCreateEltGEP(Value *Elt, ArrayRef<Value *> Idxs,
+                           GEPOperator *GEP, IRBuilder<> &Builder);
   void RewriteForConstExpr(ConstantExpr *user, IRBuilder<> &Builder);
   void RewriteForGEP(GEPOperator *GEP, IRBuilder<> &Builder);
   void RewriteForAddrSpaceCast(Value *user, IRBuilder<> &Builder);
@@ -2102,6 +2110,38 @@ bool SROAGlobalAndAllocas(HLModule &HLM, bool bHasDbgInfo) {
 // SRoA Helper
 //===----------------------------------------------------------------------===//
 
+/// GetOrCreateEltGEP - Return a GEP of Idxs off Elt that can replace GEP,
+/// reusing one created for an earlier identical access when it dominates GEP.
+Value *SROA_Helper::GetOrCreateEltGEP(Value *Elt, ArrayRef<Value *> Idxs,
+                                      GEPOperator *GEP, IRBuilder<> &Builder) {
+  Instruction *GEPInst = dyn_cast<Instruction>(GEP);
+  // DT only covers the function it was built for; globals are split across
+  // functions, so only reuse within that one.
+  bool bCanReuse = DT && GEPInst &&
+                   DT->getRoot() == &GEPInst->getParent()->getParent()->front();
+
+  SmallVector<Value *, 8> Key;
+  if (bCanReuse) {
+    Key.push_back(Elt);
+    Key.append(Idxs.begin(), Idxs.end());
+    auto It = EltGEPs.find(Key);
+    if (It != EltGEPs.end()) {
+      for (WeakVH &Cached : It->second) {
+        Instruction *CachedInst = dyn_cast_or_null<Instruction>(Cached);
+        if (CachedInst && DT->dominates(CachedInst, GEPInst))
+          return CachedInst;
+      }
+    }
+  }
+
+  Value *NewGEP = Builder.CreateInBoundsGEP(Elt, Idxs);
+  NewGEP->takeName(GEP);
+  // Constant GEPs are already uniqued by the context.
+  if (bCanReuse && isa<Instruction>(NewGEP))
+    EltGEPs[Key].push_back(NewGEP);
+  return NewGEP;
+}
+
 /// RewriteGEP - Rewrite the GEP to be relative to new element when can find a
 /// new element which is struct field. If cannot find, create new element GEPs
 /// and try to rewrite GEP with new GEPS.
@@ -2144,10 +2184,8 @@ void SROA_Helper::RewriteForGEP(GEPOperator *GEP, IRBuilder<> &Builder) {
     }
     // If only 1 level struct, just use the new pointer.
     Value *NewGEP = NewPointer;
-    if (NewArgs.size() > 1) {
-      NewGEP = Builder.CreateInBoundsGEP(NewPointer, NewArgs);
-      NewGEP->takeName(GEP);
-    }
+    if (NewArgs.size() > 1)
+      NewGEP = GetOrCreateEltGEP(NewPointer, NewArgs, GEP, Builder);
 
     assert(NewGEP->getType() == GEP->getType() && "type mismatch");
 
@@ -226,6 +226,9 @@ public:
   hlsl::DXIL::DefaultLinkage DefaultLinkage = hlsl::DXIL::DefaultLinkage::Default;
   /// Assume UAVs/SRVs may alias.
   bool HLSLResMayAlias = false;
+  /// Release IR generation state once the module is complete, before the
+  /// optimization pipeline runs.
+  bool HLSLFreeFrontendEarly = false;
   /// Lookback scan limit for memory dependencies
   unsigned ScanLimit = 0;
   /// Optimization pass enables, disables and selects
@@ -437,6 +437,30 @@ public:
     return spvStructTypeToDecl[spvTy];
   }
 
+  /// Function to add/get the SPIR-V struct type previously lowered from the
+  /// given record decl with the given layout rule. Lowering a struct computes
+  /// the layout of every field, so repeated lowerings of the same struct (e.g.
+  /// shared cbuffer or resource element types) are served from this table.
+  /// |usesArrayForMat1xN| records whether lowering used SPIR-V arrays for
+  /// HLSL 1xN matrices.
+  void registerLoweredStructType(const RecordDecl *decl, SpirvLayoutRule rule,
+                                 const StructType *spvTy,
+                                 bool usesArrayForMat1xN) {
+    assert(decl != nullptr && spvTy != nullptr);
+    loweredStructTypes[{decl, static_cast<unsigned>(rule)}] = {
+        spvTy, usesArrayForMat1xN};
+  }
+  const StructType *getLoweredStructType(const RecordDecl *decl,
+                                         SpirvLayoutRule rule,
+                                         bool *usesArrayForMat1xN) const {
+    auto it = loweredStructTypes.find({decl, static_cast<unsigned>(rule)});
+    if (it == loweredStructTypes.end())
+      return nullptr;
+    if (usesArrayForMat1xN)
+      *usesArrayForMat1xN = it->second.second;
+    return it->second.first;
+  }
+
   /// Function to add/get the mapping from a FunctionDecl to its DebugFunction.
   void registerDebugFunctionForDecl(const FunctionDecl *decl,
                                     SpirvDebugFunction *fn) {
@@ -578,6 +602,12 @@ private:
   // Mapping from SPIR-V type to Decl for a struct type.
   llvm::DenseMap<const SpirvType *, const DeclContext *> spvStructTypeToDecl;
 
+  // Mapping from (RecordDecl, SpirvLayoutRule) to the lowered SPIR-V struct
+  // type and whether 1xN matrices inside it were lowered to arrays.
+  llvm::DenseMap<std::pair<const RecordDecl *, unsigned>,
+                 std::pair<const StructType *, bool>>
+      loweredStructTypes;
+
   // Mapping from FunctionDecl to SPIR-V debug function.
   llvm::DenseMap<const FunctionDecl *, SpirvDebugFunction *>
       declToDebugFunction;
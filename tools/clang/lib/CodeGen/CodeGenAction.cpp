@@ -167,6 +167,12 @@ namespace clang {
       assert(TheModule.get() == M &&
              "Unexpected module change during IR generation");
 
+      // HLSL Change Begins - IR generation state is not needed by the
+      // optimization pipeline; don't keep it alive while that runs.
+      if (CodeGenOpts.HLSLFreeFrontendEarly)
+        Gen.reset();
+      // HLSL Change Ends
+
       // Link LinkModule into this module if present, preserving its validity.
       if (LinkModule) {
         if (Linker::LinkModules(M, LinkModule.get(),
@@ -429,6 +435,8 @@ BackendConsumer::StackSizeDiagHandler(const llvm::DiagnosticInfoStackSize &D) {
     // We do not know how to format other severities.
     return false;
 
+  if (!Gen) // HLSL Change - released early
+    return false;
   if (const Decl *ND = Gen->GetDeclForMangledName(D.getFunction().getName())) {
     Diags.Report(ND->getASTContext().getFullLoc(ND->getLocation()),
                  diag::warn_fe_frame_larger_than)
@@ -465,7 +473,7 @@ void BackendConsumer::EmitOptimizationMessage(
   // function definition. We use the definition's right brace to differentiate
   // from diagnostics that genuinely relate to the function itself.
   FullSourceLoc Loc(DILoc, SourceMgr);
-  if (Loc.isInvalid())
+  if (Loc.isInvalid() && Gen) // HLSL Change - Gen may be released early
     if (const Decl *FD = Gen->GetDeclForMangledName(D.getFunction().getName()))
       Loc = FD->getASTContext().getFullLoc(FD->getBodyRBrace());
 
@@ -483,22 +483,30 @@ void EmitVisitor::finalizeInstruction(std::vector<uint32_t> *section) {
 }
 
 std::vector<uint32_t> EmitVisitor::takeBinary() {
-  std::vector<uint32_t> result;
   Header header(takeNextId(), getHeaderVersion(featureManager.getTargetEnv()));
   auto headerBinary = header.takeBinary();
+
+  // Sections in the order mandated by the SPIR-V logical layout.
+  std::vector<uint32_t> *sections[] = {
+      &preambleBinary,    &debugFileBinary,    &debugVariableBinary,
+      &annotationsBinary, &fwdDeclBinary,      &typeConstantBinary,
+      &globalVarsBinary,  &richDebugInfo,      &mainBinary};
+
+  // Size the result once up front; modules with rich debug info can be many
+  // megabytes, and growing the vector section by section copies it repeatedly.
+  size_t numWords = headerBinary.size();
+  for (const auto *section : sections)
+    numWords += section->size();
+
+  std::vector<uint32_t> result;
+  result.reserve(numWords);
   result.insert(result.end(), headerBinary.begin(), headerBinary.end());
-  result.insert(result.end(), preambleBinary.begin(), preambleBinary.end());
-  result.insert(result.end(), debugFileBinary.begin(), debugFileBinary.end());
-  result.insert(result.end(), debugVariableBinary.begin(),
-                debugVariableBinary.end());
-  result.insert(result.end(), annotationsBinary.begin(),
-                annotationsBinary.end());
-  result.insert(result.end(), fwdDeclBinary.begin(), fwdDeclBinary.end());
-  result.insert(result.end(), typeConstantBinary.begin(),
-                typeConstantBinary.end());
-  result.insert(result.end(), globalVarsBinary.begin(), globalVarsBinary.end());
-  result.insert(result.end(), richDebugInfo.begin(), richDebugInfo.end());
-  result.insert(result.end(), mainBinary.begin(), mainBinary.end());
+  for (auto *section : sections) {
+    result.insert(result.end(), section->begin(), section->end());
+    // Release each section as soon as it is copied so the peak memory stays
+    // close to a single copy of the module.
+    std::vector<uint32_t>().swap(*section);
+  }
   return result;
 }
 
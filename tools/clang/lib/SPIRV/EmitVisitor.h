@@ -330,7 +330,8 @@ public:
 
   using Visitor::visit;
 
-  // Returns the assembled binary built up in this visitor.
+  // Returns the assembled binary built up in this visitor. The per-section
+  // buffers are released afterwards, so this may only be called once.
   std::vector<uint32_t> takeBinary();
 
 private:
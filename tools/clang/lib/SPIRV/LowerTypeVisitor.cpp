@@ -570,11 +570,26 @@ const SpirvType *LowerTypeVisitor::lowerType(QualType type,
       return spvType;
     }
 
+    bool usesArrayForMat1xN = false;
+    if (const auto *cached =
+            spvContext.getLoweredStructType(decl, rule, &usesArrayForMat1xN)) {
+      useArrayForMat1xN |= usesArrayForMat1xN;
+      return cached;
+    }
+
+    // Track whether lowering this struct alone requires arrays for 1xN
+    // matrices so cache hits can reproduce the flag.
+    const bool prevUseArrayForMat1xN = useArrayForMat1xN;
+    useArrayForMat1xN = false;
     auto loweredFields = lowerStructFields(decl, rule);
+    usesArrayForMat1xN = useArrayForMat1xN;
+    useArrayForMat1xN |= prevUseArrayForMat1xN;
 
     const auto *spvStructType =
         spvContext.getStructType(loweredFields, decl->getName());
     spvContext.registerStructDeclForSpirvType(spvStructType, decl);
+    spvContext.registerLoweredStructType(decl, rule, spvStructType,
+                                         usesArrayForMat1xN);
     return spvStructType;
   }
 
@@ -613,9 +613,13 @@ SpirvEmitter::SpirvEmitter(CompilerInstance &ci)
   spvContext.setCurrentShaderModelKind(shaderModel->GetKind());
   spvContext.setMajorVersion(shaderModel->GetMajor());
   spvContext.setMinorVersion(shaderModel->GetMinor());
+  // SPIR-V only distinguishes packed from unpacked locations, so -pack-minimal
+  // packs the same way as -pack-optimized.
   spirvOptions.signaturePacking =
       ci.getCodeGenOpts().HLSLSignaturePackingStrategy ==
-      (unsigned)hlsl::DXIL::PackingStrategy::Optimized;
+          (unsigned)hlsl::DXIL::PackingStrategy::Optimized ||
+      ci.getCodeGenOpts().HLSLSignaturePackingStrategy ==
+          (unsigned)hlsl::DXIL::PackingStrategy::Minimal;
 
   if (spirvOptions.useDxLayout) {
     spirvOptions.cBufferLayoutRule = SpirvLayoutRule::FxcCTBuffer;
@@ -966,6 +970,24 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
   // Run legalization passes
   if (spirvOptions.codeGenHighLevel) {
     beforeHlslLegalization = needsLegalization;
+  } else if (spirvOptions.fuseOptimizerPasses) {
+    // Run legalization, optimization, and capability trimming in one
+    // SPIRV-Tools pipeline.
+    std::string messages;
+    if (!spirvToolsLegalizeAndOptimize(
+            &m, &messages, needsLegalization,
+            theCompilerInstance.getCodeGenOpts().OptimizationLevel > 0,
+            &dsetbindingsToCombineImageSampler)) {
+      emitFatalError("failed to legalize and optimize SPIR-V: %0", {})
+          << messages;
+      emitNote("please file a bug report on "
+               "https://github.com/Microsoft/DirectXShaderCompiler/issues "
+               "with source code if possible",
+               {});
+      return;
+    } else if (!messages.empty()) {
+      emitWarning("SPIR-V legalization and optimization: %0", {}) << messages;
+    }
   } else {
     if (needsLegalization) {
       std::string messages;
@@ -16654,26 +16676,33 @@ bool SpirvEmitter::spirvToolsOptimize(std::vector<uint32_t> *mod,
   options.set_preserve_bindings(spirvOptions.preserveBindings);
   options.set_max_id_bound(spirvOptions.maxId);
 
+  if (!registerOptimizationPasses(&optimizer))
+    return false;
+
+  return optimizer.Run(mod->data(), mod->size(), mod, options);
+}
+
+bool SpirvEmitter::registerOptimizationPasses(spvtools::Optimizer *optimizer) {
   if (spirvOptions.optConfig.empty()) {
     // Add performance passes.
-    optimizer.RegisterPerformancePasses(spirvOptions.preserveInterface);
+    optimizer->RegisterPerformancePasses(spirvOptions.preserveInterface);
 
     // Add propagation of volatile semantics passes.
-    optimizer.RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
+    optimizer->RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
 
     // Add compact ID pass.
-    optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
+    optimizer->RegisterPass(spvtools::CreateCompactIdsPass());
   } else {
     // Command line options use llvm::SmallVector and llvm::StringRef, whereas
     // SPIR-V optimizer uses std::vector and std::string.
     std::vector<std::string> stdFlags;
     for (const auto &f : spirvOptions.optConfig)
       stdFlags.push_back(f.str());
-    if (!optimizer.RegisterPassesFromFlags(stdFlags))
+    if (!optimizer->RegisterPassesFromFlags(stdFlags))
       return false;
   }
 
-  return optimizer.Run(mod->data(), mod->size(), mod, options);
+  return true;
 }
 
 bool SpirvEmitter::spirvToolsLegalize(std::vector<uint32_t> *mod,
@@ -16696,54 +16725,97 @@ bool SpirvEmitter::spirvToolsLegalize(std::vector<uint32_t> *mod,
   options.set_preserve_bindings(spirvOptions.preserveBindings);
   options.set_max_id_bound(spirvOptions.maxId);
 
+  registerLegalizationPasses(&optimizer, dsetbindingsToCombineImageSampler);
+
+  return optimizer.Run(mod->data(), mod->size(), mod, options);
+}
+
+void SpirvEmitter::registerLegalizationPasses(
+    spvtools::Optimizer *optimizer,
+    const std::vector<DescriptorSetAndBinding>
+        *dsetbindingsToCombineImageSampler) {
   // Add interface variable SROA if the signature packing is enabled.
   if (spirvOptions.signaturePacking) {
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateInterfaceVariableScalarReplacementPass());
   }
-  optimizer.RegisterLegalizationPasses(spirvOptions.preserveInterface);
+  optimizer->RegisterLegalizationPasses(spirvOptions.preserveInterface);
   // Add flattening of resources if needed.
   if (spirvOptions.flattenResourceArrays) {
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateReplaceDescArrayAccessUsingVarIndexPass());
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateDescriptorArrayScalarReplacementPass());
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
   }
   if (declIdMapper.requiresFlatteningCompositeResources()) {
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateDescriptorCompositeScalarReplacementPass());
     // ADCE should be run after desc_sroa in order to remove potentially
     // illegal types such as structures containing opaque types.
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
   }
   if (dsetbindingsToCombineImageSampler &&
       !dsetbindingsToCombineImageSampler->empty()) {
-    optimizer.RegisterPass(spvtools::CreateConvertToSampledImagePass(
+    optimizer->RegisterPass(spvtools::CreateConvertToSampledImagePass(
         *dsetbindingsToCombineImageSampler));
     // ADCE should be run after combining images and samplers in order to
     // remove potentially illegal types such as structures containing opaque
     // types.
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
   }
   if (spirvOptions.reduceLoadSize) {
     // The threshold must be bigger than 1.0 to reduce all possible loads.
-    optimizer.RegisterPass(spvtools::CreateReduceLoadSizePass(1.1));
+    optimizer->RegisterPass(spvtools::CreateReduceLoadSizePass(1.1));
     // ADCE should be run after reduce-load-size pass in order to remove
     // dead instructions.
-    optimizer.RegisterPass(
+    optimizer->RegisterPass(
         spvtools::CreateAggressiveDCEPass(spirvOptions.preserveInterface));
   }
-  optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
-  optimizer.RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
+  optimizer->RegisterPass(spvtools::CreateCompactIdsPass());
+  optimizer->RegisterPass(spvtools::CreateSpreadVolatileSemanticsPass());
   if (spirvOptions.fixFuncCallArguments) {
-    optimizer.RegisterPass(spvtools::CreateFixFuncCallArgumentsPass());
+    optimizer->RegisterPass(spvtools::CreateFixFuncCallArgumentsPass());
   }
+}
+
+bool SpirvEmitter::spirvToolsLegalizeAndOptimize(
+    std::vector<uint32_t> *mod, std::string *messages, bool legalize,
+    bool optimize,
+    const std::vector<DescriptorSetAndBinding>
+        *dsetbindingsToCombineImageSampler) {
+  spvtools::Optimizer optimizer(featureManager.getTargetEnv());
+  optimizer.SetMessageConsumer(
+      [messages](spv_message_level_t /*level*/, const char * /*source*/,
+                 const spv_position_t & /*position*/,
+                 const char *message) { *messages += message; });
+
+  string::RawOstreamBuf printAllBuf(llvm::errs());
+  std::ostream printAllOS(&printAllBuf);
+  if (spirvOptions.printAll)
+    optimizer.SetPrintAll(&printAllOS);
+
+  spvtools::OptimizerOptions options;
+  options.set_run_validator(false);
+  options.set_preserve_bindings(spirvOptions.preserveBindings);
+  options.set_max_id_bound(spirvOptions.maxId);
+
+  // Register every stage into the same optimizer so that the module is parsed
+  // into an IRContext once and serialized once, instead of once per stage.
+  // The passes run in the same order as the separate stages would.
+  if (legalize)
+    registerLegalizationPasses(&optimizer, dsetbindingsToCombineImageSampler);
+  if (optimize && !registerOptimizationPasses(&optimizer))
+    return false;
+  if (spirvOptions.debugInfoRich)
+    optimizer.RegisterPass(
+        spvtools::CreateOpExtInstWithForwardReferenceFixupPass());
+  optimizer.RegisterPass(spvtools::CreateTrimCapabilitiesPass());
 
   return optimizer.Run(mod->data(), mod->size(), mod, options);
 }
@@ -1340,6 +1340,10 @@ private:
   /// Returns true on success and false otherwise.
   bool spirvToolsOptimize(std::vector<uint32_t> *mod, std::string *messages);
 
+  /// Registers the optimization passes selected by -O or -Oconfig into
+  /// |optimizer|. Returns false if the -Oconfig flags are invalid.
+  bool registerOptimizationPasses(spvtools::Optimizer *optimizer);
+
   // \brief Runs the pass represented by the given pass token on the module.
   // Returns true if the pass was successfully run. Any messages from the
   // optimizer are returned in `messages`.
@@ -1379,6 +1383,24 @@ private:
                      const std::vector<spvtools::opt::DescriptorSetAndBinding>
                          *dsetbindingsToCombineImageSampler);
 
+  /// Registers the legalization passes used by spirvToolsLegalize into
+  /// |optimizer|.
+  void registerLegalizationPasses(
+      spvtools::Optimizer *optimizer,
+      const std::vector<spvtools::opt::DescriptorSetAndBinding>
+          *dsetbindingsToCombineImageSampler);
+
+  /// \brief Runs legalization (if |legalize|), optimization (if |optimize|),
+  /// OpExtInst fixup and capability trimming on |mod| with a single
+  /// SPIRV-Tools optimizer, so the module is only parsed and serialized once.
+  /// Used for -fspv-fuse-optimizer-passes.
+  /// Returns true on success and false otherwise.
+  bool spirvToolsLegalizeAndOptimize(
+      std::vector<uint32_t> *mod, std::string *messages, bool legalize,
+      bool optimize,
+      const std::vector<spvtools::opt::DescriptorSetAndBinding>
+          *dsetbindingsToCombineImageSampler);
+
   /// \brief Helper function to run the SPIRV-Tools validator.
   /// Runs the SPIRV-Tools validator on the given SPIR-V module |mod|, and
   /// gets the info/warning/error messages via |messages|.
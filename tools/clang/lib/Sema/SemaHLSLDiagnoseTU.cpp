@@ -121,6 +121,30 @@ public:
   }
 };
 
+// Direct callees of each function, gathered by traversing its body once.
+// Libraries build a call graph per export, and exports share most of their
+// callees, so this keeps each body from being traversed again per export.
+class FnCalleeCache {
+private:
+  CallNodes m_callees;
+  FunctionSet m_traversedFunctions;
+
+public:
+  // Returns the node for F, or null if F references no functions.
+  const CallNode *GetCallees(FunctionDecl *F) {
+    if (m_traversedFunctions.insert(F).second) {
+      FunctionSet visitedFunctions;
+      PendingFunctions pendingFunctions;
+      FnReferenceVisitor visitor(visitedFunctions, pendingFunctions,
+                                 m_callees);
+      visitor.setSourceFn(F);
+      visitor.TraverseDecl(F);
+    }
+    auto it = m_callees.find(F);
+    return it == m_callees.end() ? nullptr : &it->second;
+  }
+};
+
 // A call graph that can check for reachability and recursion efficiently.
 class CallGraphWithRecurseGuard {
 private:
@@ -149,28 +173,43 @@ private:
     return nullptr;
   }
 
+  void AddCallees(FunctionDecl *F, FnCalleeCache &CalleeCache,
+                  PendingFunctions &pendingFunctions) {
+    const CallNode *callees = CalleeCache.GetCallees(F);
+    if (!callees)
+      return;
+    CallNode &node =
+        m_callNodes.insert(std::make_pair(F, CallNode{F, {}})).first->second;
+    for (FunctionDecl *Callee : callees->CalleeFns) {
+      node.CalleeFns.insert(Callee);
+      if (!m_visitedFunctions.count(Callee))
+        pendingFunctions.push_back(Callee);
+    }
+  }
+
 public:
   void BuildForEntry(FunctionDecl *EntryFnDecl,
-                     llvm::ArrayRef<VarDecl *> GlobalsWithInit) {
+                     llvm::ArrayRef<VarDecl *> GlobalsWithInit,
+                     FnCalleeCache &CalleeCache) {
     DXASSERT_NOMSG(EntryFnDecl);
     EntryFnDecl = getFunctionWithBody(EntryFnDecl);
     PendingFunctions pendingFunctions;
     FnReferenceVisitor visitor(m_visitedFunctions, pendingFunctions,
                                m_callNodes);
 
-    // First, traverse all initializers, then entry function.
+    // First, traverse all initializers, then entry function.  Initializers
+    // are attributed to this entry only, so they are not cached.
     m_visitedFunctions.insert(EntryFnDecl);
     visitor.setSourceFn(EntryFnDecl);
     for (VarDecl *VD : GlobalsWithInit)
       visitor.TraverseDecl(VD);
-    visitor.TraverseDecl(EntryFnDecl);
+    if (EntryFnDecl)
+      AddCallees(EntryFnDecl, CalleeCache, pendingFunctions);
 
     while (!pendingFunctions.empty()) {
       FunctionDecl *pendingDecl = pendingFunctions.pop_back_val();
-      if (m_visitedFunctions.insert(pendingDecl).second == true) {
-        visitor.setSourceFn(pendingDecl);
-        visitor.TraverseDecl(pendingDecl);
-      }
+      if (m_visitedFunctions.insert(pendingDecl).second == true)
+        AddCallees(pendingDecl, CalleeCache, pendingFunctions);
     }
   }
 
@@ -196,7 +235,7 @@ public:
 
   const CallNodes &GetCallGraph() { return m_callNodes; }
 
-  const FunctionSet GetVisitedFunctions() { return m_visitedFunctions; }
+  const FunctionSet &GetVisitedFunctions() { return m_visitedFunctions; }
 
   void dump() const {
     llvm::dbgs() << "Call Nodes:\n";
@@ -335,14 +374,14 @@ void GatherGlobalsWithInitializers(
 //  (viable as in, is exported)
 clang::FunctionDecl *
 ValidateNoRecursion(CallGraphWithRecurseGuard &callGraph,
-                    clang::FunctionDecl *FD,
+                    FnCalleeCache &CalleeCache, clang::FunctionDecl *FD,
                     llvm::ArrayRef<VarDecl *> GlobalsWithInit) {
   // Validate that there is no recursion reachable by this function declaration
   // NOTE: the information gathered here could be used to bypass code generation
   // on functions that are unreachable (as an early form of dead code
   // elimination).
   if (FD) {
-    callGraph.BuildForEntry(FD, GlobalsWithInit);
+    callGraph.BuildForEntry(FD, GlobalsWithInit, CalleeCache);
     return callGraph.CheckRecursion(FD);
   }
   return nullptr;
@@ -641,13 +680,15 @@ void hlsl::DiagnoseTranslationUnit(clang::Sema *self) {
   }
 
   // for each FDecl, check for recursion
+  FnCalleeCache CalleeCache;
   for (FunctionDecl *FDecl : FDeclsToCheck) {
     CallGraphWithRecurseGuard callGraph;
     ArrayRef<VarDecl *> InitGlobals = {};
     // if entry function, include globals with initializers.
     if (FDecl->hasAttr<HLSLShaderAttr>())
       InitGlobals = GlobalsWithInit;
-    FunctionDecl *result = ValidateNoRecursion(callGraph, FDecl, InitGlobals);
+    FunctionDecl *result =
+        ValidateNoRecursion(callGraph, CalleeCache, FDecl, InitGlobals);
 
     if (result) {
       // don't emit duplicate diagnostics for the same recursive function
@@ -677,7 +718,8 @@ void hlsl::DiagnoseTranslationUnit(clang::Sema *self) {
 
     if (pPatchFnDecl) {
       FunctionDecl *patchResult =
-          ValidateNoRecursion(callGraph, pPatchFnDecl, GlobalsWithInit);
+          ValidateNoRecursion(callGraph, CalleeCache, pPatchFnDecl,
+                              GlobalsWithInit);
 
       // In this case, recursion was detected in the patch-constant function
       if (patchResult) {
@@ -0,0 +1,23 @@
+// RUN: %dxc -T ps_6_0 -E main -spirv -O3 -fspv-fuse-optimizer-passes %s | FileCheck %s
+// RUN: %dxc -T ps_6_0 -E main -spirv -O0 -fspv-fuse-optimizer-passes %s | FileCheck %s --check-prefix=O0
+
+// Legalization, optimization and capability trimming run in a single
+// SPIRV-Tools pipeline. The result must still be legal, optimized SPIR-V.
+
+// CHECK: OpEntryPoint Fragment %main
+// CHECK-NOT: OpFunctionCall
+
+// O0: OpEntryPoint Fragment %main
+// O0: OpFunctionCall
+
+struct Input
+{
+  float4 color : COLOR;
+};
+
+float4 scale(float4 c) { return c * 2.0; }
+
+float4 main(Input input) : SV_TARGET
+{
+  return scale(input.color);
+}
@@ -0,0 +1,6 @@
+#ifndef DEPENDENCY6_H_
+#define DEPENDENCY6_H_
+
+// Empty
+
+#endif  // DEPENDENCY6_H_
@@ -0,0 +1,9 @@
+// DeadOnly is only read by code that optimization removes, so it must not
+// show up in the reflection of an optimized compile.
+Texture2D<float4> Used : register(t0);
+Texture2D<float4> DeadOnly : register(t1);
+
+float4 main(float2 uv : TEXCOORD0) : SV_Target {
+  float4 dead = DeadOnly.Load(int3(0, 0, 0));
+  return Used.Load(int3(uv, 0));
+}
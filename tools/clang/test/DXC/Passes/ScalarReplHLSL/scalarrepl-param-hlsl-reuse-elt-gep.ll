@@ -0,0 +1,84 @@
+; RUN: %dxopt %s -hlsl-passes-resume -scalarrepl-param-hlsl -S | FileCheck %s
+
+; Roughly the following HLSL, with the index loaded once:
+;   struct S { float a[4]; float b; };
+;   static int g;
+;   static float r;
+;
+;   [numthreads(1, 1, 1)]
+;   void main() {
+;     S s;
+;     s.b = 1;
+;     s.a[g] = 2;
+;     r = s.a[g] + s.b;
+;   }
+;
+; When 's' is split, both accesses to s.a[g] are rewritten onto the new
+; [4 x float] element. The second access must reuse the element GEP created
+; for the first instead of emitting an identical one.
+
+; CHECK: %[[A:[^ ,]+]] = alloca [4 x float]
+; CHECK: %[[GEP:[^ ,]+]] = getelementptr inbounds [4 x float], [4 x float]* %[[A]], i32 0, i32 %idx
+; CHECK: store float 2.000000e+00, float* %[[GEP]]
+; CHECK-NOT: getelementptr inbounds [4 x float], [4 x float]* %[[A]]
+; CHECK: load float, float* %[[GEP]]
+; CHECK: ret void
+
+target datalayout = "e-m:e-p:32:32-i1:32-i8:32-i16:32-i32:32-i64:64-f16:32-f32:32-f64:64-n8:16:32:64"
+target triple = "dxil-ms-dx"
+
+%struct.S = type { [4 x float], float }
+%ConstantBuffer = type opaque
+
+@g = internal global i32 0, align 4
+@r = internal global float 0.000000e+00, align 4
+@"$Globals" = external constant %ConstantBuffer
+
+; Function Attrs: nounwind
+define void @main() #0 {
+entry:
+  %s = alloca %struct.S, align 4
+  %b = getelementptr inbounds %struct.S, %struct.S* %s, i32 0, i32 1
+  store float 1.000000e+00, float* %b, align 4
+  %idx = load i32, i32* @g, align 4
+  %a0 = getelementptr inbounds %struct.S, %struct.S* %s, i32 0, i32 0, i32 %idx
+  store float 2.000000e+00, float* %a0, align 4
+  %a1 = getelementptr inbounds %struct.S, %struct.S* %s, i32 0, i32 0, i32 %idx
+  %0 = load float, float* %a1, align 4
+  %b1 = getelementptr inbounds %struct.S, %struct.S* %s, i32 0, i32 1
+  %1 = load float, float* %b1, align 4
+  %add = fadd float %0, %1
+  store float %add, float* @r, align 4
+  ret void
+}
+
+attributes #0 = { nounwind }
+
+!pauseresume = !{!0}
+!dx.version = !{!1}
+!dx.valver = !{!2}
+!dx.shaderModel = !{!3}
+!dx.typeAnnotations = !{!4, !8}
+!dx.entryPoints = !{!12}
+!dx.fnprops = !{!16}
+!dx.options = !{!17, !18}
+
+!0 = !{!"hlsl-hlemit", !"hlsl-hlensure"}
+!1 = !{i32 1, i32 0}
+!2 = !{i32 1, i32 8}
+!3 = !{!"cs", i32 6, i32 0}
+!4 = !{i32 0, %struct.S undef, !5}
+!5 = !{i32 56, !6, !7}
+!6 = !{i32 6, !"a", i32 3, i32 0, i32 7, i32 9}
+!7 = !{i32 6, !"b", i32 3, i32 52, i32 7, i32 9}
+!8 = !{i32 1, void ()* @main, !9}
+!9 = !{!10}
+!10 = !{i32 1, !11, !11}
+!11 = !{}
+!12 = !{void ()* @main, !"main", null, !13, null}
+!13 = !{null, null, !14, null}
+!14 = !{!15}
+!15 = !{i32 0, %ConstantBuffer* @"$Globals", !"$Globals", i32 0, i32 -1, i32 1, i32 0, null}
+!16 = !{void ()* @main, i32 5, i32 1, i32 1, i32 1}
+!17 = !{i32 64}
+!18 = !{i32 -1}
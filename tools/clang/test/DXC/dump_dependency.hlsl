@@ -12,6 +12,7 @@
 // CHECK-DAG:dependency3.h
 // CHECK-DAG:dependency4.h
 // CHECK-DAG:dependency5.h
+// CHECK-DAG:dependency6.h
 
 // RUN: rm %S/dump_dependency.d
 
@@ -19,6 +20,10 @@
 #include "include/dependency0.h"
 #include "include/dependency2.h"
 
+// Macros in directives must still expand when only scanning dependencies.
+#define DEPENDENCY6_FILE "include/dependency6.h"
+#include DEPENDENCY6_FILE
+
 float4 main() : SV_Target
 {
   return 0;
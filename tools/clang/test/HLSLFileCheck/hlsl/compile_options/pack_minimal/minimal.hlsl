@@ -0,0 +1,44 @@
+// RUN: %dxc -E main -T vs_6_0 -pack-minimal %s | FileCheck %s
+// RUN: %dxc -E main -T vs_6_0 -pack_optimized %s | FileCheck %s -check-prefix=OPT
+// RUN: not %dxc -E main -T vs_6_0 -pack-minimal -pack_optimized %s 2>&1 | FileCheck %s -check-prefix=ERR
+
+// Greedy packing places both three row elements first, which leaves no room
+// for the three component arrays beside them and takes 7 rows.  The minimal
+// search packs the same elements into 5 rows.
+
+// CHECK:      ; Output signature:
+// CHECK:      ; A                        0   xyz         0     NONE   float   xyz
+// CHECK-NEXT: ; A                        1   xyz         1     NONE   float   xyz
+// CHECK-NEXT: ; B                        0    yzw        3     NONE   float    yzw
+// CHECK-NEXT: ; B                        1    yzw        4     NONE   float    yzw
+// CHECK-NEXT: ; C                        0      w        0     NONE   float      w
+// CHECK-NEXT: ; C                        1      w        1     NONE   float      w
+// CHECK-NEXT: ; C                        2      w        2     NONE   float      w
+// CHECK-NEXT: ; D                        0   x           2     NONE   float   x
+// CHECK-NEXT: ; D                        1   x           3     NONE   float   x
+// CHECK-NEXT: ; D                        2   x           4     NONE   float   x
+
+// OPT:      ; Output signature:
+// OPT:      ; A                        0   xyz         3     NONE   float   xyz
+// OPT-NEXT: ; A                        1   xyz         4     NONE   float   xyz
+// OPT-NEXT: ; B                        0   xyz         5     NONE   float   xyz
+// OPT-NEXT: ; B                        1   xyz         6     NONE   float   xyz
+// OPT-NEXT: ; C                        0   x           0     NONE   float   x
+// OPT-NEXT: ; C                        1   x           1     NONE   float   x
+// OPT-NEXT: ; C                        2   x           2     NONE   float   x
+// OPT-NEXT: ; D                        0    y          0     NONE   float    y
+// OPT-NEXT: ; D                        1    y          1     NONE   float    y
+// OPT-NEXT: ; D                        2    y          2     NONE   float    y
+
+// ERR: Cannot specify /pack-minimal with /pack_prefix_stable or /pack_optimized
+
+struct VS_OUT {
+  float3 a[2] : A;
+  float3 b[2] : B;
+  float c[3] : C;
+  float d[3] : D;
+};
+
+VS_OUT main() {
+	return (VS_OUT)1.0F;
+}
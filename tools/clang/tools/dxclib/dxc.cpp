@@ -1409,6 +1409,84 @@ static LONG CALLBACK ExceptionFilter(PEXCEPTION_POINTERS pExceptionInfo) {
 }
 #endif
 
+// Runs every command line in the batch file (one per line, arguments
+// separated by spaces, "//" starting a comment line) in this process, so the
+// compiler library is loaded and initialized only once for all of them.
+static int BatchCompile(DxcOpts &batchOpts,
+                        DxcDllExtValidationLoader &dxcSupport) {
+  const OptTable *optionTable = getHlslOptTable();
+  CComPtr<IDxcBlobEncoding> pBatch;
+  ReadFileIntoBlob(dxcSupport, StringRefWide(batchOpts.InputFile), &pBatch);
+  llvm::StringRef source((const char *)pBatch->GetBufferPointer(),
+                         pBatch->GetBufferSize());
+  llvm::SmallVector<llvm::StringRef, 16> commands;
+  source.split(commands, "\n", /*MaxSplit*/ -1, /*KeepEmpty*/ false);
+
+  int retVal = 0;
+  for (llvm::StringRef command : commands) {
+    // trim to remove /r if exist.
+    command = command.trim();
+    if (command.empty() || command.startswith("//"))
+      continue;
+
+    llvm::SmallVector<llvm::StringRef, 16> args;
+    command.split(args, " ", /*MaxSplit*/ -1, /*KeepEmpty*/ false);
+    MainArgs argStrings(args);
+    DxcOpts dxcOpts;
+    std::string errorString;
+    llvm::raw_string_ostream errorStream(errorString);
+    int optResult =
+        ReadDxcOpts(optionTable, DxcFlags, argStrings, dxcOpts, errorStream);
+    errorStream.flush();
+    if (errorString.size())
+      fprintf(stderr, "dxc %s : %s: %s\n", optResult ? "failed" : "warning",
+              command.str().c_str(), errorString.c_str());
+    if (optResult != 0) {
+      retVal = 1;
+      continue;
+    }
+    if (dxcOpts.Batch || !dxcOpts.ExternalLib.empty() ||
+        !dxcOpts.ExternalFn.empty()) {
+      fprintf(stderr,
+              "dxc failed : %s: -batch and -external are not supported "
+              "inside a batch file\n",
+              command.str().c_str());
+      retVal = 1;
+      continue;
+    }
+    if (dxcOpts.EntryPoint.empty() && !dxcOpts.RecompileFromBinary)
+      dxcOpts.EntryPoint = "main";
+
+    try {
+      DxcContext context(dxcOpts, dxcSupport);
+      int ret = 0;
+      if (!dxcOpts.Preprocess.empty())
+        context.Preprocess();
+      else if (dxcOpts.DumpBin)
+        ret = context.DumpBinary();
+      else if (dxcOpts.Link)
+        ret = context.Link();
+      else
+        ret = context.Compile();
+      if (ret)
+        retVal = ret;
+    } catch (const ::hlsl::Exception &hlslException) {
+      const char *msg = hlslException.what();
+      if (msg == nullptr || *msg == '\0')
+        fprintf(stderr, "dxc failed : %s: error code 0x%08x.\n",
+                command.str().c_str(), hlslException.hr);
+      else
+        fprintf(stderr, "dxc failed : %s: %s\n", command.str().c_str(), msg);
+      retVal = 1;
+    } catch (std::bad_alloc &) {
+      fprintf(stderr, "dxc failed : %s: out of memory.\n",
+              command.str().c_str());
+      retVal = 1;
+    }
+  }
+  return retVal;
+}
+
 #ifdef _WIN32
 int dxc::main(int argc, const wchar_t **argv_) {
 #else
@@ -1524,7 +1602,10 @@ int dxc::main(int argc, const char **argv_) {
     }
 
     // TODO: implement all other actions.
-    if (!dxcOpts.Preprocess.empty()) {
+    if (dxcOpts.Batch) {
+      pStage = "Batch compilation";
+      retVal = BatchCompile(dxcOpts, dxcSupport);
+    } else if (!dxcOpts.Preprocess.empty()) {
       pStage = "Preprocessing";
       context.Preprocess();
     } else if (dxcOpts.DumpBin) {
@@ -54,7 +54,7 @@ bool SigElementHasStream(const DxilProgramSignatureElement &pSignature) {
 }
 
 void PrintSignature(LPCSTR pName, const DxilProgramSignature *pSignature,
-                    bool bIsInput, raw_string_ostream &OS, StringRef comment) {
+                    bool bIsInput, raw_ostream &OS, StringRef comment) {
   OS << comment << "\n"
      << comment << " " << pName << " signature:\n"
      << comment << "\n"
@@ -267,7 +267,7 @@ void PrintSignature(LPCSTR pName, const DxilProgramSignature *pSignature,
   OS << comment << "\n";
 }
 
-void PintCompMaskNameCompact(raw_string_ostream &OS, unsigned CompMask) {
+void PintCompMaskNameCompact(raw_ostream &OS, unsigned CompMask) {
   char Mask[5];
   memset(Mask, '\0', sizeof(Mask));
   unsigned idx = 0;
@@ -283,7 +283,7 @@ void PintCompMaskNameCompact(raw_string_ostream &OS, unsigned CompMask) {
 }
 
 void PrintDxilSignature(LPCSTR pName, const DxilSignature &Signature,
-                        raw_string_ostream &OS, StringRef comment) {
+                        raw_ostream &OS, StringRef comment) {
   const std::vector<std::unique_ptr<DxilSignatureElement>> &sigElts =
       Signature.GetElements();
   if (sigElts.size() == 0)
@@ -361,7 +361,7 @@ static_assert(_countof(g_pOptFeatureInfoNames) == OptFeatureInfoCount,
               "g_pOptFeatureInfoNames needs to be updated");
 
 void PrintFeatureInfo(const DxilShaderFeatureInfo *pFeatureInfo,
-                      raw_string_ostream &OS, StringRef comment) {
+                      raw_ostream &OS, StringRef comment) {
   uint64_t featureFlags = pFeatureInfo->FeatureFlags;
   if (!featureFlags)
     return;
@@ -385,7 +385,7 @@ void PrintFeatureInfo(const DxilShaderFeatureInfo *pFeatureInfo,
 }
 
 void PrintResourceFormat(DxilResourceBase &res, unsigned alignment,
-                         raw_string_ostream &OS) {
+                         raw_ostream &OS) {
   switch (res.GetClass()) {
   case DxilResourceBase::Class::CBuffer:
   case DxilResourceBase::Class::Sampler:
@@ -415,7 +415,7 @@ void PrintResourceFormat(DxilResourceBase &res, unsigned alignment,
 }
 
 void PrintResourceDim(DxilResourceBase &res, unsigned alignment,
-                      raw_string_ostream &OS) {
+                      raw_ostream &OS) {
   switch (res.GetClass()) {
   case DxilResourceBase::Class::CBuffer:
   case DxilResourceBase::Class::Sampler:
@@ -457,7 +457,7 @@ void PrintResourceDim(DxilResourceBase &res, unsigned alignment,
   }
 }
 
-void PrintResourceBinding(DxilResourceBase &res, raw_string_ostream &OS,
+void PrintResourceBinding(DxilResourceBase &res, raw_ostream &OS,
                           StringRef comment) {
   OS << comment << " " << left_justify(res.GetGlobalName(), 31);
 
@@ -483,8 +483,7 @@ void PrintResourceBinding(DxilResourceBase &res, raw_string_ostream &OS,
     OS << right_justify("unbounded", 6) << "\n";
 }
 
-void PrintResourceBindings(DxilModule &M, raw_string_ostream &OS,
-                           StringRef comment) {
+void PrintResourceBindings(DxilModule &M, raw_ostream &OS, StringRef comment) {
   OS << comment << "\n"
      << comment << " Resource Bindings:\n"
      << comment << "\n"
@@ -550,8 +549,7 @@ void PrintInputsContributingToOutputs(
   }
 }
 
-void PrintViewIdState(DxilModule &M, raw_string_ostream &OS,
-                      StringRef comment) {
+void PrintViewIdState(DxilModule &M, raw_ostream &OS, StringRef comment) {
   if (!M.GetModule()->getNamedMetadata("dx.viewIdState"))
     return;
 
@@ -687,7 +685,7 @@ static const char *HitGroupTypeToString(DXIL::HitGroupType type) {
   return "<invalid HitGroupType>";
 }
 
-template <typename _T> void PrintFlags(raw_string_ostream &OS, uint32_t Flags) {
+template <typename _T> void PrintFlags(raw_ostream &OS, uint32_t Flags) {
   if (!Flags) {
     OS << "0";
     return;
@@ -702,7 +700,7 @@ template <typename _T> void PrintFlags(raw_string_ostream &OS, uint32_t Flags) {
   }
 }
 
-void PrintSubobjects(const DxilSubobjects &subobjects, raw_string_ostream &OS,
+void PrintSubobjects(const DxilSubobjects &subobjects, raw_ostream &OS,
                      StringRef comment) {
   if (subobjects.GetSubobjects().empty())
     return;
@@ -822,10 +820,9 @@ void PrintSubobjects(const DxilSubobjects &subobjects, raw_string_ostream &OS,
 }
 
 void PrintStructLayout(StructType *ST, DxilTypeSystem &typeSys,
-                       const DataLayout *DL, raw_string_ostream &OS,
-                       StringRef comment, StringRef varName, unsigned offset,
-                       unsigned indent, unsigned arraySize,
-                       unsigned sizeOfStruct = 0);
+                       const DataLayout *DL, raw_ostream &OS, StringRef comment,
+                       StringRef varName, unsigned offset, unsigned indent,
+                       unsigned arraySize, unsigned sizeOfStruct = 0);
 
 void PrintTypeAndName(llvm::Type *Ty, DxilFieldAnnotation &annotation,
                       std::string &StreamStr, unsigned arraySize,
@@ -863,8 +860,8 @@ void PrintTypeAndName(llvm::Type *Ty, DxilFieldAnnotation &annotation,
 
 void PrintFieldLayout(llvm::Type *Ty, DxilFieldAnnotation &annotation,
                       DxilTypeSystem &typeSys, const DataLayout *DL,
-                      raw_string_ostream &OS, StringRef comment,
-                      unsigned offset, unsigned indent, unsigned offsetIndent,
+                      raw_ostream &OS, StringRef comment, unsigned offset,
+                      unsigned indent, unsigned offsetIndent,
                       unsigned sizeToPrint = 0) {
   if (Ty->isStructTy() && !annotation.HasMatrixAnnotation()) {
     PrintStructLayout(cast<StructType>(Ty), typeSys, DL, OS, comment,
@@ -933,10 +930,9 @@ void PrintFieldLayout(llvm::Type *Ty, DxilFieldAnnotation &annotation,
 
 // null DataLayout => assume constant buffer layout
 void PrintStructLayout(StructType *ST, DxilTypeSystem &typeSys,
-                       const DataLayout *DL, raw_string_ostream &OS,
-                       StringRef comment, StringRef varName, unsigned offset,
-                       unsigned indent, unsigned offsetIndent,
-                       unsigned sizeOfStruct) {
+                       const DataLayout *DL, raw_ostream &OS, StringRef comment,
+                       StringRef varName, unsigned offset, unsigned indent,
+                       unsigned offsetIndent, unsigned sizeOfStruct) {
   DxilStructAnnotation *annotation = typeSys.GetStructAnnotation(ST);
   (OS << comment).indent(indent) << "struct " << ST->getName() << "\n";
   (OS << comment).indent(indent) << "{\n";
@@ -980,7 +976,7 @@ void PrintStructLayout(StructType *ST, DxilTypeSystem &typeSys,
 }
 
 void PrintStructBufferDefinition(DxilResource *buf, DxilTypeSystem &typeSys,
-                                 const DataLayout &DL, raw_string_ostream &OS,
+                                 const DataLayout &DL, raw_ostream &OS,
                                  StringRef comment) {
   const unsigned offsetIndent = 50;
 
@@ -1027,7 +1023,7 @@ void PrintStructBufferDefinition(DxilResource *buf, DxilTypeSystem &typeSys,
 }
 
 void PrintTBufferDefinition(DxilResource *buf, DxilTypeSystem &typeSys,
-                            raw_string_ostream &OS, StringRef comment) {
+                            raw_ostream &OS, StringRef comment) {
   const unsigned offsetIndent = 50;
   llvm::Type *Ty = buf->GetHLSLType()->getPointerElementType();
   // For TextureBuffer<> buf[2], the array size is in Resource binding count
@@ -1053,7 +1049,7 @@ void PrintTBufferDefinition(DxilResource *buf, DxilTypeSystem &typeSys,
 }
 
 void PrintCBufferDefinition(DxilCBuffer *buf, DxilTypeSystem &typeSys,
-                            raw_string_ostream &OS, StringRef comment) {
+                            raw_ostream &OS, StringRef comment) {
   const unsigned offsetIndent = 50;
   llvm::Type *Ty = buf->GetHLSLType()->getPointerElementType();
   // For ConstantBuffer<> buf[2], the array size is in Resource binding count
@@ -1079,8 +1075,7 @@ void PrintCBufferDefinition(DxilCBuffer *buf, DxilTypeSystem &typeSys,
   OS << comment << "\n";
 }
 
-void PrintBufferDefinitions(DxilModule &M, raw_string_ostream &OS,
-                            StringRef comment) {
+void PrintBufferDefinitions(DxilModule &M, raw_ostream &OS, StringRef comment) {
   OS << comment << "\n"
      << comment << " Buffer Definitions:\n"
      << comment << "\n";
@@ -1354,7 +1349,7 @@ public:
 void PrintPipelineStateValidationRuntimeInfo(const char *pBuffer,
                                              const uint32_t uBufferSize,
                                              DXIL::ShaderKind shaderKind,
-                                             raw_string_ostream &OS,
+                                             raw_ostream &OS,
                                              StringRef comment) {
   OS << comment << "\n"
      << comment << " Pipeline Runtime Information: \n"
@@ -1370,7 +1365,7 @@ void PrintPipelineStateValidationRuntimeInfo(const char *pBuffer,
 
 namespace dxcutil {
 
-HRESULT Disassemble(IDxcBlob *pProgram, raw_string_ostream &Stream) {
+HRESULT Disassemble(IDxcBlob *pProgram, raw_ostream &Stream) {
   CComPtr<IDxcBlob> pPdbContainerBlob;
   {
     CComPtr<IStream> pStream;
@@ -1501,6 +1496,14 @@ HRESULT Disassemble(IDxcBlob *pProgram, raw_string_ostream &Stream) {
     }
 
   } else {
+    // A reflection part on its own, as written by /Fre or -reflect-only.
+    const DxilPartHeader *pPart = reinterpret_cast<const DxilPartHeader *>(pIL);
+    if (pILLength >= sizeof(DxilPartHeader) &&
+        pPart->PartFourCC == DFCC_ShaderStatistics &&
+        pPart->PartSize <= pILLength - sizeof(DxilPartHeader)) {
+      pIL = GetDxilPartData(pPart);
+      pILLength = pPart->PartSize;
+    }
     const DxilProgramHeader *pProgramHeader =
         reinterpret_cast<const DxilProgramHeader *>(pIL);
     if (IsValidDxilProgramHeader(pProgramHeader, pILLength)) {
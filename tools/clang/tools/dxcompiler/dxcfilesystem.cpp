@@ -22,6 +22,8 @@
 #include "dxc/Support/dxcfilesystem.h"
 #include "clang/Frontend/CompilerInstance.h"
 
+#include <unordered_map>
+
 #ifndef _WIN32
 #include <sys/stat.h>
 #include <unistd.h>
@@ -212,6 +214,9 @@ private:
         : Blob(pBlob), BlobStream(pStream), Name(name) {}
   };
   llvm::SmallVector<IncludedFile, 4> m_includedFiles;
+  // Index into m_includedFiles by name; clang probes the same names many
+  // times, so avoid a linear scan per open.
+  std::unordered_map<std::wstring, size_t> m_includedFileIndex;
 
   static bool IsDirOf(LPCWSTR lpDir, size_t dirLen,
                       const std::wstring &fileName) {
@@ -254,11 +259,10 @@ private:
     return INVALID_HANDLE_VALUE;
   }
   DWORD TryFindOrOpen(LPCWSTR lpFileName, size_t &index) {
-    for (size_t i = 0; i < m_includedFiles.size(); ++i) {
-      if (0 == wcscmp(lpFileName, m_includedFiles[i].Name.data())) {
-        index = i;
-        return ERROR_SUCCESS;
-      }
+    auto it = m_includedFileIndex.find(lpFileName);
+    if (it != m_includedFileIndex.end()) {
+      index = it->second;
+      return ERROR_SUCCESS;
     }
 
     if (m_includeLoader.p != nullptr) {
@@ -287,6 +291,7 @@ private:
         m_includedFiles.emplace_back(std::wstring(lpFileName), fileBlobUtf8,
                                      fileStream);
         index = m_includedFiles.size() - 1;
+        m_includedFileIndex.emplace(m_includedFiles.back().Name, index);
 
         if (m_bDisplayIncludeProcess) {
           std::string openFileStr;
@@ -326,6 +331,7 @@ public:
     IFT(CreateReadOnlyBlobStream(m_pSource, &m_pSourceStream));
     m_includedFiles.push_back(
         IncludedFile(std::wstring(m_pSourceName), m_pSource, m_pSourceStream));
+    m_includedFileIndex.emplace(m_includedFiles.back().Name, 0);
   }
   void EnableDisplayIncludeProcess() override {
     m_bDisplayIncludeProcess = true;
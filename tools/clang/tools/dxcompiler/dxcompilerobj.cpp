@@ -38,6 +38,7 @@
 #include "dxc/Support/Path.h"
 #include "dxc/Support/WinIncludes.h"
 #include "dxc/Support/dxcfilesystem.h"
+#include "dxc/Support/dxcmem.h"
 #include "dxc/dxcapi.internal.h"
 #include "dxcutil.h"
 
@@ -431,19 +432,37 @@ public:
   }
 };
 
-static void CreateDefineStrings(const DxcDefine *pDefines, UINT defineCount,
+static void CreateDefineStrings(const hlsl::options::DxcDefines &Defines,
                                 std::vector<std::string> &defines) {
-  // Not very efficient but also not very important.
-  for (UINT32 i = 0; i < defineCount; i++) {
-    CW2A utf8Name(pDefines[i].Name);
-    CW2A utf8Value(pDefines[i].Value);
-    std::string val(utf8Name.m_psz);
-    val += "=";
-    val += (pDefines[i].Value) ? utf8Value.m_psz : "1";
-    defines.push_back(val);
+  // DxcDefines still holds the UTF-8 "name[=value]" arguments it was built
+  // from (they point into the MainArgs storage, which outlives the compile),
+  // so use them directly instead of converting the wide copies back.
+  defines.reserve(defines.size() + Defines.DefineStrings.size());
+  for (llvm::StringRef S : Defines.DefineStrings) {
+    std::string val = S;
+    if (S.find('=') == StringRef::npos)
+      val += "=1";
+    defines.push_back(std::move(val));
   }
 }
 
+static HRESULT ErrorForMemoryBudget(DxcBudgetMalloc *pBudgetMalloc,
+                                    REFIID riid, void **ppResult) {
+  std::string error;
+  raw_string_ostream OS(error);
+  OS << "error: compilation exceeded the memory budget of ";
+  pBudgetMalloc->WriteBudget(OS);
+  OS << " during " << pBudgetMalloc->GetExceededPhaseName() << "\n";
+  pBudgetMalloc->WritePeaks(OS);
+  OS.flush();
+  CComPtr<IDxcResult> pResult;
+  IFR(DxcResult::Create(
+      E_OUTOFMEMORY, DXC_OUT_NONE,
+      {DxcOutputObject::ErrorOutput(CP_UTF8, error.data(), error.size())},
+      &pResult));
+  return pResult->QueryInterface(riid, ppResult);
+}
+
 static HRESULT ErrorWithString(const std::string &error, REFIID riid,
                                void **ppResult) {
   CComPtr<IDxcResult> pResult;
@@ -539,6 +558,7 @@ public:
     bool bCompileStarted = false;
     bool bPreprocessStarted = false;
     DxilShaderHash ShaderHashContent;
+    CComPtr<DxcBudgetMalloc> pBudgetMalloc;
     DxcThreadMalloc TM(m_pMalloc);
 
     try {
@@ -570,6 +590,20 @@ public:
         }
       }
 
+      // From here on, allocations made through the thread malloc count
+      // against the memory budget, if one was given.
+      if (opts.MemoryBudgetKB) {
+        if (DxcBudgetMalloc::CanTrack(m_pMalloc)) {
+          pBudgetMalloc = DxcBudgetMalloc::Alloc(
+              m_pMalloc, (uint64_t)opts.MemoryBudgetKB << 10);
+          IFTOOM(pBudgetMalloc.p);
+        } else {
+          w << "warning: -memory-budget ignored, the allocator cannot "
+               "report block sizes\n";
+        }
+      }
+      DxcThreadMalloc BudgetTM(pBudgetMalloc ? pBudgetMalloc.p : m_pMalloc.p);
+
       bool isPreprocessing = !opts.Preprocess.empty();
       if (isPreprocessing) {
         DxcEtw_DXCompilerPreprocess_Start();
@@ -622,21 +656,15 @@ public:
             static_cast<const char *>(pOrigUtf8Source->GetStringPointer()),
             pOrigUtf8Source->GetStringLength());
 
-        CComPtr<IDxcResult> pSrcCodeResult;
-        std::vector<LPCWSTR> PreprocessArgs;
-        PreprocessArgs.reserve(argCount + 1);
-        PreprocessArgs.assign(pArguments, pArguments + argCount);
-        PreprocessArgs.push_back(L"-P");
-        PreprocessArgs.push_back(L"-Fi");
-        PreprocessArgs.push_back(L"preprocessed.hlsl");
-        IFT(Compile(pSource, PreprocessArgs.data(), PreprocessArgs.size(),
-                    pIncludeHandler, IID_PPV_ARGS(&pSrcCodeResult)));
-        HRESULT status;
-        IFT(pSrcCodeResult->GetStatus(&status));
-        if (SUCCEEDED(status)) {
-          pSourceEncoding.Release();
-          IFT(pSrcCodeResult->GetOutput(
-              DXC_OUT_HLSL, IID_PPV_ARGS(&pSourceEncoding), nullptr));
+        // Preprocess with the options already parsed rather than going
+        // through Compile again with -P. On failure keep the original
+        // source; the compile below reports the errors.
+        CComPtr<IDxcBlobEncoding> pPreprocessed;
+        IFT(PreprocessToBlob(pOrigUtf8Source, pUtf8SourceName,
+                             pWideSourceName, pIncludeHandler, opts,
+                             pArguments, argCount, &pPreprocessed));
+        if (pPreprocessed) {
+          pSourceEncoding = pPreprocessed;
         }
       }
 #endif // ENABLE_SPIRV_CODEGEN
@@ -680,14 +708,16 @@ public:
       StringRef Data(utf8Source->GetStringPointer(),
                      utf8Source->GetStringLength());
 
-      // Not very efficient but also not very important.
       std::vector<std::string> defines;
-      CreateDefineStrings(opts.Defines.data(), opts.Defines.size(), defines);
+      CreateDefineStrings(opts.Defines, defines);
 
       // Setup a compiler instance.
       raw_stream_ostream outStream(pOutputStream.p);
-      llvm::LLVMContext
-          llvmContext; // LLVMContext should outlive CompilerInstance
+      // LLVMContext should outlive CompilerInstance. It is not pooled across
+      // compiles: uniqued types, constants and metadata live as long as the
+      // context and cannot be dropped, so a reused context would keep growing
+      // and leak state (named struct types, metadata kinds) between shaders.
+      llvm::LLVMContext llvmContext;
       std::unique_ptr<llvm::Module> debugModule;
       CComPtr<AbstractMemoryStream> pReflectionStream;
       CompilerInstance compiler;
@@ -718,19 +748,12 @@ public:
       bool needsValidation = false;
       bool validateRootSigContainer = false;
 
+      if (pBudgetMalloc)
+        pBudgetMalloc->SetPhase(DxcBudgetMalloc::PhaseFrontend);
+
       if (isPreprocessing) {
         TimeTraceScope TimeScope("PreprocessAction", StringRef(""));
-        // These settings are back-compatible with fxc.
-        clang::PreprocessorOutputOptions &PPOutOpts =
-            compiler.getPreprocessorOutputOpts();
-        PPOutOpts.ShowCPP = 1;         // Print normal preprocessed output.
-        PPOutOpts.ShowComments = 0;    // Show comments.
-        PPOutOpts.ShowLineMarkers = 1; // Show \#line markers.
-        PPOutOpts.UseLineDirectives =
-            1; // Use \#line instead of GCC-style \# N.
-        PPOutOpts.ShowMacroComments = 0; // Show comments, even in macros.
-        PPOutOpts.ShowMacros = 0;        // Print macro definitions.
-        PPOutOpts.RewriteIncludes = 0;   // Preprocess include directives only.
+        SetupPreprocessorOutputOptions(compiler.getPreprocessorOutputOpts());
 
         FrontendInputFile file(pUtf8SourceName, IK_HLSL);
         clang::PrintPreprocessedAction action;
@@ -872,6 +895,9 @@ public:
         auto dependencyCollector = std::make_shared<DependencyCollector>();
         compiler.addDependencyCollector(dependencyCollector);
         compiler.createPreprocessor(clang::TranslationUnitKind::TU_Complete);
+        // Only directives can pull in files, so don't pay for expanding
+        // macros in the body of the shader; #if and #include still expand.
+        compiler.getPreprocessor().SetMacroExpansionOnlyInDirectives();
 
         clang::PreprocessOnlyAction preprocessAction;
         FrontendInputFile file(pUtf8SourceName, IK_HLSL);
@@ -980,6 +1006,12 @@ public:
           compileOK = false;
         }
         outStream.flush();
+        // Sema and the AST are gone after EndSourceFile, but the preprocessor
+        // (macros, identifiers, header search) would otherwise stay alive
+        // through validation and container serialization. The source manager
+        // is kept for diagnostics and PDB source info.
+        if (opts.FreeFrontendEarly)
+          compiler.setPreprocessor(nullptr);
 
         SerializeDxilFlags SerializeFlags =
             hlsl::options::ComputeSerializeDxilFlags(opts);
@@ -1027,6 +1059,8 @@ public:
         // representation in the module.
         if (compileOK && !opts.CodeGenHighLevel) {
           TimeTraceScope TimeScope("AssembleAndWriteContainer", StringRef(""));
+          if (pBudgetMalloc)
+            pBudgetMalloc->SetPhase(DxcBudgetMalloc::PhaseContainer);
           HRESULT valHR = S_OK;
           CComPtr<AbstractMemoryStream> pRootSigStream;
           IFT(CreateMemoryStream(DxcGetThreadMallocNoRef(),
@@ -1048,14 +1082,22 @@ public:
 
           inputs.pVersionInfo = static_cast<IDxcVersionInfo *>(this);
 
-          if (needsValidation) {
+          if (opts.ReflectOnly) {
+            // No container, PSV, hash or root signature; the reflection part
+            // is both the object and the reflection output.
+            hlsl::SerializeDxilReflectionForModule(
+                &inputs.pM->GetOrCreateDxilModule(), pReflectionStream);
+            pOutputBlob.Release();
+            IFT(pReflectionStream->QueryInterface(&pOutputBlob));
+            IFT(pResult->SetOutputObject(DXC_OUT_REFLECTION, pOutputBlob));
+          } else if (needsValidation) {
             valHR = dxcutil::ValidateAndAssembleToContainer(inputs);
           } else {
             dxcutil::AssembleToContainer(inputs);
           }
 
           // Callback after valid DXIL is produced
-          if (SUCCEEDED(valHR)) {
+          if (SUCCEEDED(valHR) && !opts.ReflectOnly) {
             CComPtr<IDxcBlob> pTargetBlob;
             if (m_pDxcContainerEventsHandler != nullptr) {
               HRESULT hr = m_pDxcContainerEventsHandler->OnDxilContainerBuilt(
@@ -1232,6 +1274,8 @@ public:
       // SPIRV change ends
 
       if (!hasErrorOccurred && writePDB) {
+        if (pBudgetMalloc)
+          pBudgetMalloc->SetPhase(DxcBudgetMalloc::PhaseDebugInfo);
         CComPtr<IDxcBlob> pStrippedContainer;
         {
           // Create the shader source information for PDB
@@ -1303,6 +1347,21 @@ public:
         } // PDB in private
       }   // Write PDB
 
+      if (pBudgetMalloc) {
+        // An allocation failure may have been recovered from along the way;
+        // the compile still failed to stay within budget.
+        if (pBudgetMalloc->IsExceeded())
+          throw std::bad_alloc();
+        if (IsBlobNullOrEmpty(pErrorBlob)) {
+          // The remarks were already set above, before the PDB phase.
+          pBudgetMalloc->WritePeaks(r);
+          r.flush();
+          IFT(pResult->ClearOutput(DXC_OUT_REMARKS));
+          IFT(pResult->SetOutputString(DXC_OUT_REMARKS, remarks.c_str(),
+                                       remarks.size()));
+        }
+      }
+
       IFT(primaryOutput.SetObject(pOutputBlob, opts.DefaultTextCodePage));
       IFT(pResult->SetOutput(primaryOutput));
 
@@ -1320,17 +1379,25 @@ public:
       hr = S_OK;
     } catch (std::bad_alloc &) {
       hr = E_OUTOFMEMORY;
+      if (pBudgetMalloc && pBudgetMalloc->IsExceeded() &&
+          SUCCEEDED(ErrorForMemoryBudget(pBudgetMalloc, riid, ppResult)))
+        hr = S_OK;
     } catch (hlsl::Exception &e) {
       assert(DXC_FAILED(e.hr));
       CComPtr<IDxcResult> pResult;
       hr = e.hr;
       std::string msg("Internal Compiler error: ");
       msg += e.msg;
-      if (SUCCEEDED(DxcResult::Create(
-              e.hr, DXC_OUT_NONE,
-              {DxcOutputObject::ErrorOutput(CP_UTF8, msg.c_str(), msg.size())},
-              &pResult)) &&
-          SUCCEEDED(pResult->QueryInterface(riid, ppResult))) {
+      if (pBudgetMalloc && pBudgetMalloc->IsExceeded()) {
+        hr = E_OUTOFMEMORY;
+        if (SUCCEEDED(ErrorForMemoryBudget(pBudgetMalloc, riid, ppResult)))
+          hr = S_OK;
+      } else if (SUCCEEDED(DxcResult::Create(
+                     e.hr, DXC_OUT_NONE,
+                     {DxcOutputObject::ErrorOutput(CP_UTF8, msg.c_str(),
+                                                   msg.size())},
+                     &pResult)) &&
+                 SUCCEEDED(pResult->QueryInterface(riid, ppResult))) {
         hr = S_OK;
       }
     } catch (...) {
@@ -1375,18 +1442,33 @@ public:
       ::llvm::sys::fs::AutoPerThreadSystem pts(msf.get());
       IFTLLVM(pts.error_code());
 
-      std::string StreamStr;
-      raw_string_ostream Stream(StreamStr);
-
       CComPtr<IDxcBlobEncoding> pProgram;
       IFT(hlsl::DxcCreateBlob(pObject->Ptr, pObject->Size, true, false, false,
                               0, nullptr, &pProgram))
-      IFC(dxcutil::Disassemble(pProgram, Stream));
 
-      IFT(DxcResult::Create(S_OK, DXC_OUT_DISASSEMBLY,
-                            {DxcOutputObject::StringOutput(
-                                DXC_OUT_DISASSEMBLY, CP_UTF8, StreamStr.c_str(),
-                                StreamStr.size(), DxcOutNoName)},
+      // Print straight into the memory stream that backs the result, rather
+      // than into a string that is then copied; large libraries produce
+      // disassembly in the hundreds of MB.
+      CComPtr<AbstractMemoryStream> pDisassemblyStream;
+      IFT(CreateMemoryStream(m_pMalloc, &pDisassemblyStream));
+      {
+        raw_stream_ostream Stream(pDisassemblyStream.p);
+        IFC(dxcutil::Disassemble(pProgram, Stream));
+        // Null-terminated UTF-8 lets the blob wrap the stream without a copy.
+        Stream << '\0';
+      }
+
+      CComPtr<IDxcBlob> pDisassemblyBlob;
+      IFT(pDisassemblyStream->QueryInterface(&pDisassemblyBlob));
+      CComPtr<IDxcBlobEncoding> pDisassembly;
+      IFT(hlsl::DxcCreateBlobWithEncodingSet(pDisassemblyBlob, CP_UTF8,
+                                             &pDisassembly));
+      DxcOutputObject disassemblyOutput;
+      disassemblyOutput.kind = DXC_OUT_DISASSEMBLY;
+      // Already UTF-8, so no code page translation is needed.
+      IFT(disassemblyOutput.SetObject(pDisassembly, /*codePage*/ 0));
+
+      IFT(DxcResult::Create(S_OK, DXC_OUT_DISASSEMBLY, {disassemblyOutput},
                             &pResult));
       IFT(pResult->QueryInterface(riid, ppResult));
 
@@ -1412,6 +1494,80 @@ public:
     return hr;
   }
 
+  static void
+  SetupPreprocessorOutputOptions(clang::PreprocessorOutputOptions &PPOutOpts) {
+    // These settings are back-compatible with fxc.
+    PPOutOpts.ShowCPP = 1;           // Print normal preprocessed output.
+    PPOutOpts.ShowComments = 0;      // Show comments.
+    PPOutOpts.ShowLineMarkers = 1;   // Show \#line markers.
+    PPOutOpts.UseLineDirectives = 1; // Use \#line instead of GCC-style \# N.
+    PPOutOpts.ShowMacroComments = 0; // Show comments, even in macros.
+    PPOutOpts.ShowMacros = 0;        // Print macro definitions.
+    PPOutOpts.RewriteIncludes = 0;   // Preprocess include directives only.
+  }
+
+#ifdef ENABLE_SPIRV_CODEGEN
+  // Preprocesses pUtf8Source into a UTF-8 blob, as -P would. Sets
+  // *ppPreprocessed to nullptr if preprocessing reported an error.
+  HRESULT PreprocessToBlob(IDxcBlobUtf8 *pUtf8Source, LPCSTR pUtf8SourceName,
+                           LPCWSTR pWideSourceName,
+                           IDxcIncludeHandler *pIncludeHandler,
+                           hlsl::options::DxcOpts &opts, LPCWSTR *pArguments,
+                           UINT32 argCount,
+                           IDxcBlobEncoding **ppPreprocessed) {
+    TimeTraceScope TimeScope("PreprocessAction", StringRef(""));
+    *ppPreprocessed = nullptr;
+
+    dxcutil::DxcArgsFileSystem *msfPtr = dxcutil::CreateDxcArgsFileSystem(
+        pUtf8Source, pWideSourceName, pIncludeHandler,
+        opts.DefaultTextCodePage);
+    std::unique_ptr<::llvm::sys::fs::MSFileSystem> msf(msfPtr);
+    ::llvm::sys::fs::AutoPerThreadSystem pts(msf.get());
+    IFTLLVM(pts.error_code());
+
+    CComPtr<AbstractMemoryStream> pOutputStream;
+    IFT(CreateMemoryStream(m_pMalloc, &pOutputStream));
+    IFT(msfPtr->RegisterOutputStream(L"output.bc", pOutputStream));
+    IFT(msfPtr->CreateStdStreams(m_pMalloc));
+
+    std::vector<std::string> defines;
+    CreateDefineStrings(opts.Defines, defines);
+
+    // Diagnostics are dropped here; the compile of the original source
+    // reports them if preprocessing fails.
+    std::string warnings;
+    raw_string_ostream w(warnings);
+    raw_stream_ostream outStream(pOutputStream.p);
+    CompilerInstance compiler;
+    std::unique_ptr<TextDiagnosticPrinter> diagPrinter =
+        llvm::make_unique<TextDiagnosticPrinter>(w,
+                                                 &compiler.getDiagnosticOpts());
+    SetupCompilerForCompile(compiler, &m_langExtensionsHelper, pUtf8SourceName,
+                            diagPrinter.get(), defines, opts, pArguments,
+                            argCount);
+    msfPtr->SetupForCompilerInstance(compiler);
+    compiler.getFrontendOpts().OutputFile = "output.bc";
+    compiler.WriteDefaultOutputDirectly = true;
+    compiler.setOutStream(&outStream);
+    SetupPreprocessorOutputOptions(compiler.getPreprocessorOutputOpts());
+
+    FrontendInputFile file(pUtf8SourceName, IK_HLSL);
+    clang::PrintPreprocessedAction action;
+    if (!action.BeginSourceFile(compiler, file))
+      return S_OK;
+    action.Execute();
+    action.EndSourceFile();
+    outStream.flush();
+    if (compiler.getDiagnostics().hasErrorOccurred())
+      return S_OK;
+
+    CComPtr<IDxcBlob> pOutputBlob;
+    IFT(pOutputStream.QueryInterface(&pOutputBlob));
+    return hlsl::DxcCreateBlobWithEncodingSet(pOutputBlob, CP_UTF8,
+                                              ppPreprocessed);
+  }
+#endif // ENABLE_SPIRV_CODEGEN
+
   void SetupCompilerForCompile(CompilerInstance &compiler,
                                DxcLangExtensionsHelper *helper,
                                LPCSTR pMainFile,
@@ -1598,6 +1754,7 @@ public:
     compiler.getCodeGenOpts().HLSLOnlyWarnOnUnrollFail =
         Opts.EnableFXCCompatMode;
     compiler.getCodeGenOpts().HLSLResMayAlias = Opts.ResMayAlias;
+    compiler.getCodeGenOpts().HLSLFreeFrontendEarly = Opts.FreeFrontendEarly;
     compiler.getCodeGenOpts().ScanLimit = Opts.ScanLimit;
     compiler.getCodeGenOpts().HLSLOptimizationToggles = Opts.OptToggles;
     compiler.getCodeGenOpts().HLSLAllResourcesBound = Opts.AllResourcesBound;
@@ -1629,6 +1786,9 @@ public:
     else if (Opts.PackOptimized)
       compiler.getCodeGenOpts().HLSLSignaturePackingStrategy =
           (unsigned)DXIL::PackingStrategy::Optimized;
+    else if (Opts.PackMinimal)
+      compiler.getCodeGenOpts().HLSLSignaturePackingStrategy =
+          (unsigned)DXIL::PackingStrategy::Minimal;
     else
       compiler.getCodeGenOpts().HLSLSignaturePackingStrategy =
           (unsigned)DXIL::PackingStrategy::Default;
@@ -28,7 +28,7 @@ namespace llvm {
 class LLVMContext;
 class MemoryBuffer;
 class Module;
-class raw_string_ostream;
+class raw_ostream;
 class Twine;
 } // namespace llvm
 
@@ -77,7 +77,7 @@ ValidateRootSignatureInContainer(IDxcBlob *pRootSigContainer,
 HRESULT SetRootSignature(hlsl::DxilModule *pModule, CComPtr<IDxcBlob> pSource);
 void GetValidatorVersion(unsigned *pMajor, unsigned *pMinor);
 void AssembleToContainer(AssembleInputs &inputs);
-HRESULT Disassemble(IDxcBlob *pProgram, llvm::raw_string_ostream &Stream);
+HRESULT Disassemble(IDxcBlob *pProgram, llvm::raw_ostream &Stream);
 void ReadOptsAndValidate(hlsl::options::MainArgs &mainArgs,
                          hlsl::options::DxcOpts &opts,
                          hlsl::AbstractMemoryStream *pOutputStream,
@@ -195,6 +195,7 @@ public:
   TEST_METHOD(CompileThenCheckDisplayIncludeProcess)
   TEST_METHOD(CompileThenPrintTimeReport)
   TEST_METHOD(CompileThenPrintTimeTrace)
+  TEST_METHOD(CompileWhenMemoryBudgetExceededThenOOM)
   TEST_METHOD(CompileWhenIncludeMissingThenFail)
   TEST_METHOD(CompileWhenIncludeHasPathThenOK)
   TEST_METHOD(CompileWhenIncludeEmptyThenOK)
@@ -3461,6 +3462,38 @@ TEST_F(CompilerTest, CompileThenPrintTimeTrace) {
   VERIFY_ARE_NOT_EQUAL(string::npos, text.find("{ \"traceEvents\": ["));
 }
 
+// Only Windows routes operator new through the thread IMalloc, so elsewhere
+// most of the compiler's allocations are not counted against the budget.
+#ifdef _WIN32
+TEST_F(CompilerTest, CompileWhenMemoryBudgetExceededThenOOM) {
+#else
+TEST_F(CompilerTest, DISABLED_CompileWhenMemoryBudgetExceededThenOOM) {
+#endif
+  CComPtr<IDxcCompiler> pCompiler;
+  CComPtr<IDxcOperationResult> pResult;
+  CComPtr<IDxcBlobEncoding> pSource;
+
+  VERIFY_SUCCEEDED(CreateCompiler(&pCompiler));
+  CreateBlobFromText("float4 main() : SV_Target { return 0.0; }", &pSource);
+
+  LPCWSTR args[] = {L"-memory-budget", L"1"};
+  VERIFY_SUCCEEDED(pCompiler->Compile(pSource, L"source.hlsl", L"main",
+                                      L"ps_6_0", args, _countof(args), nullptr,
+                                      0, nullptr, &pResult));
+  HRESULT status;
+  VERIFY_SUCCEEDED(pResult->GetStatus(&status));
+  VERIFY_ARE_EQUAL(E_OUTOFMEMORY, status);
+
+  CComPtr<IDxcBlobEncoding> pErrors;
+  VERIFY_SUCCEEDED(pResult->GetErrorBuffer(&pErrors));
+  std::string text(BlobToUtf8(pErrors));
+  VERIFY_ARE_NOT_EQUAL(
+      string::npos, text.find("exceeded the memory budget of 1 MB during "));
+  VERIFY_ARE_EQUAL(string::npos, text.find("unknown phase"));
+  VERIFY_ARE_NOT_EQUAL(string::npos,
+                       text.find("Peak memory by phase (budget 1 MB):"));
+}
+
 TEST_F(CompilerTest, CompileWhenIncludeMissingThenFail) {
   CComPtr<IDxcCompiler> pCompiler;
   CComPtr<IDxcOperationResult> pResult;
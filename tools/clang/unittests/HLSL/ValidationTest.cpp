@@ -21,11 +21,13 @@
 #include "dxc/DxilContainer/DxilContainerAssembler.h"
 #include "dxc/DxilContainer/DxilPipelineStateValidation.h"
 #include "dxc/DxilHash/DxilHash.h"
+#include "dxc/DxilRootSignature/DxilRootSignature.h"
 #include "dxc/Support/Unicode.h" // for wstring conversions like WideToUtf8String
 #include "dxc/Support/WinIncludes.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Regex.h"
+#include "llvm/Support/raw_ostream.h"
 #include <wchar.h>
 
 #ifdef _WIN32
@@ -239,6 +241,7 @@ public:
   TEST_METHOD(WhenRootSigMatchShaderFail_Unbounded1)
   TEST_METHOD(WhenRootSigMatchShaderFail_Unbounded2)
   TEST_METHOD(WhenRootSigMatchShaderFail_Unbounded3)
+  TEST_METHOD(WhenRootSigMatchShaderPSVsThenReportPerShader)
   TEST_METHOD(WhenProgramOutSigMissingThenFail)
   TEST_METHOD(WhenProgramOutSigUnexpectedThenFail)
   TEST_METHOD(WhenProgramSigMismatchThenFail)
@@ -2979,6 +2982,57 @@ TEST_F(ValidationTest, WhenRootSigMatchShaderFail_Unbounded3) {
        "Validation failed."});
 }
 
+TEST_F(ValidationTest, WhenRootSigMatchShaderPSVsThenReportPerShader) {
+  CComPtr<IDxcBlob> pRootSigProgram, pCompatProgram, pIncompatProgram;
+  if (!CompileSource("float c; [RootSignature ( \"RootConstants(b0, "
+                     "num32BitConstants = 1)\" )] "
+                     "float4 main() : semantic { return c; }",
+                     "vs_6_0", &pRootSigProgram))
+    return;
+  VERIFY_IS_TRUE(CompileSource(
+      "float c; float4 main() : semantic { return c; }", "vs_6_0",
+      &pCompatProgram));
+  VERIFY_IS_TRUE(CompileSource(
+      "cbuffer CB : register(b3) { float c; } "
+      "float4 main() : semantic { return c; }",
+      "vs_6_0", &pIncompatProgram));
+
+  auto GetPart = [](IDxcBlob *pProgram, DxilFourCC FourCC) {
+    const DxilPartHeader *pPart = GetDxilPartByType(
+        (const DxilContainerHeader *)pProgram->GetBufferPointer(), FourCC);
+    VERIFY_IS_NOT_NULL(pPart);
+    return pPart;
+  };
+
+  const DxilPartHeader *pRootSigPart =
+      GetPart(pRootSigProgram, DFCC_RootSignature);
+  DxilVersionedRootSignature RootSig;
+  DeserializeRootSignature(GetDxilPartData(pRootSigPart),
+                           pRootSigPart->PartSize, RootSig.get_address_of());
+
+  const DxilPartHeader *pPSVParts[] = {
+      GetPart(pCompatProgram, DFCC_PipelineStateValidation),
+      GetPart(pIncompatProgram, DFCC_PipelineStateValidation)};
+  DXIL::ShaderKind ShaderKinds[] = {DXIL::ShaderKind::Vertex,
+                                    DXIL::ShaderKind::Vertex};
+  const void *pPSVData[] = {GetDxilPartData(pPSVParts[0]),
+                            GetDxilPartData(pPSVParts[1])};
+  uint32_t PSVSizes[] = {pPSVParts[0]->PartSize, pPSVParts[1]->PartSize};
+  bool Results[2] = {false, false};
+
+  std::string Diags;
+  llvm::raw_string_ostream DiagStream(Diags);
+  VERIFY_IS_FALSE(VerifyRootSignatureWithShaderPSVs(
+      RootSig.get(), 2, ShaderKinds, pPSVData, PSVSizes, Results, DiagStream));
+  DiagStream.flush();
+
+  VERIFY_IS_TRUE(Results[0]);
+  VERIFY_IS_FALSE(Results[1]);
+  // Only the incompatible shader reports, and it is identified by index.
+  VERIFY_IS_TRUE(llvm::StringRef(Diags).startswith("shader 1: "));
+  VERIFY_ARE_EQUAL(std::string::npos, Diags.find("shader 0: "));
+}
+
 #define VERTEX_STRUCT1                                                         \
   "struct PSSceneIn \n\
     { \n\